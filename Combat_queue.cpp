@@ -0,0 +1,102 @@
+#include "Combat_queue.h"
+#include "Ship.h"
+#include "Ship_handle_table.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+using std::size_t;
+using std::stable_sort;
+using std::vector;
+
+// turn keeping the shots until resolve is called on or off
+void Combat_queue::set_batched(bool enabled) {
+    batched = enabled;
+    if(!batched) {
+        resolve();
+    }
+}
+
+// queue a shot by attacker at target; it is carried out at once unless batched
+void Combat_queue::add_shot(const Ship& attacker, const Ship& target, int firepower) {
+    shots.push_back(Shot{attacker.get_handle(), target.get_handle(), firepower});
+    if(!batched) {
+        resolve();
+    }
+}
+
+// carry out every shot queued
+/* The shots are moved out of the queue first, since a response can be a Ship
+deciding to attack, which does not fire until its next update but could in
+principle queue more shots. When batched, the shots are sorted by target so that
+the damage to each is totaled in one run; the sort is stable, so each run keeps the
+order the attackers fired in, and the first shot of each target and attacker is
+the one that gets the response. */
+void Combat_queue::resolve() {
+    if(shots.empty()) {
+        return;
+    }
+    batch.swap(shots);
+    Ship_handle_table& handles = Ship_handle_table::get_instance();
+    if(!batched) {
+        for(const Shot& shot : batch) {
+            carry_out(shot);
+        }
+        batch.clear();
+        return;
+    }
+    stable_sort(batch.begin(), batch.end(), [&handles](const Shot& s1, const Shot& s2) {
+        const Ship* t1 = handles.get(s1.target);
+        const Ship* t2 = handles.get(s2.target);
+        // shots at sunk Ships go last and are dropped
+        if(!t1 || !t2) {
+            return t1 && !t2;
+        }
+        return t1->get_name() < t2->get_name();
+    });
+    targets.clear();
+    for(const Shot& shot : batch) {
+        targets.push_back(handles.get(shot.target));
+    }
+    // damage, in one run of shots for each target
+    for(size_t run_begin = 0; run_begin < batch.size() && targets[run_begin];) {
+        int total_firepower = 0;
+        size_t run_end = run_begin;
+        for(; run_end < batch.size() && targets[run_end] == targets[run_begin]; ++run_end) {
+            total_firepower += batch[run_end].firepower;
+        }
+        targets[run_begin]->receive_hit(total_firepower);
+        run_begin = run_end;
+    }
+    // responses, skipping repeated target and attacker pairs within each run
+    for(size_t shot_index = 0; shot_index < batch.size() && targets[shot_index]; ++shot_index) {
+        Ship* attacker_ptr = handles.get(batch[shot_index].attacker);
+        if(!attacker_ptr) {
+            continue;
+        }
+        bool repeated = false;
+        for(size_t earlier = shot_index; earlier > 0 && targets[earlier - 1] == targets[shot_index]; --earlier) {
+            if(handles.get(batch[earlier - 1].attacker) == attacker_ptr) {
+                repeated = true;
+                break;
+            }
+        }
+        if(!repeated) {
+            targets[shot_index]->respond_to_hit(attacker_ptr->shared_from_this());
+        }
+    }
+    batch.clear();
+}
+
+// hit the target and have it respond to the attacker, even if the hit sinks it;
+// nothing if either has sunk since the shot was fired
+void Combat_queue::carry_out(const Shot& shot) {
+    Ship_handle_table& handles = Ship_handle_table::get_instance();
+    Ship* target_ptr = handles.get(shot.target);
+    Ship* attacker_ptr = handles.get(shot.attacker);
+    if(!target_ptr || !attacker_ptr) {
+        return;
+    }
+    target_ptr->receive_hit(shot.firepower);
+    target_ptr->respond_to_hit(attacker_ptr->shared_from_this());
+}
@@ -0,0 +1,67 @@
+/* Combat_queue class
+A Combat_queue collects the shots that Warships fire and carries them out: the hit
+on the target, and then the target's response to the attacker (see
+Ship::respond_to_hit). No exceptions are involved, and a Ship that sinks is only
+taken out of the Model at the end of the tick (see Model::remove_ship), so the
+objects being updated stay put.
+
+By default each shot is carried out as soon as it is fired, so that everything
+happens in the same order as if the target had been hit on the spot. The queue can
+be batched instead: then the shots of a whole tick are kept until the Model
+resolves them, once every object has been updated. The damage is totaled for each
+target, the hits are applied in alphabetical order of the targets, and then each
+target, sunk or not, responds once to each of its attackers that is still afloat,
+in the order they first fired. Ships then fire at targets that another Ship has sunk earlier in
+the same tick, and the messages come out in a different order, so batching is off
+unless asked for.
+
+Shots refer to the Ships by their handles (see Ship_handle_table); a shot whose
+target has sunk by the time it is carried out does nothing.
+*/
+#ifndef COMBAT_QUEUE_H
+#define COMBAT_QUEUE_H
+#include "Ship_handle_table.h"
+#include <vector>
+
+class Ship;
+
+class Combat_queue {
+public:
+    Combat_queue() : batched(false) { }
+
+    // disallow copy/move construction or assignment
+    Combat_queue(Combat_queue& other)=delete;
+    Combat_queue(Combat_queue&& other)=delete;
+    Combat_queue& operator=(Combat_queue& rhs)=delete;
+    Combat_queue& operator=(Combat_queue&& rhs)=delete;
+
+    // turn keeping the shots until resolve is called on or off
+    void set_batched(bool enabled);
+    bool get_batched() const {return batched;}
+
+    // queue a shot by attacker at target; it is carried out at once unless batched
+    void add_shot(const Ship& attacker, const Ship& target, int firepower);
+    // carry out every shot queued
+    void resolve();
+    // drop every shot queued
+    void clear() {shots.clear();}
+
+private:
+    struct Shot {
+        Ship_handle attacker;
+        Ship_handle target;
+        int firepower;
+    };
+
+    bool batched;
+    std::vector<Shot> shots;
+    // scratch space for resolve, kept so that its storage is reused
+    std::vector<Shot> batch;
+    std::vector<Ship*> targets;     // of the shots in batch, nullptr if sunk
+
+    // hit the target and have it respond to the attacker, even if the hit sinks it;
+    // nothing if either has sunk since the shot was fired
+    static void carry_out(const Shot& shot);
+};
+
+#endif
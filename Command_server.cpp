@@ -0,0 +1,255 @@
+#include "Command_server.h"
+#include "Utility.h"
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+using std::size_t;
+using std::string;
+
+const char* const socket_error_c = "Could not open socket!";
+// how much is read from a client at a time
+const size_t client_read_size_c = 65536;
+// lines are not run for a client with this much reply still to be sent
+const size_t max_waiting_reply_c = 1 << 20;
+// a client that sends this much without ending a line is disconnected
+const size_t max_line_length_c = 1 << 20;
+const int max_events_c = 64;
+
+// listen at socket_path, replacing a socket left there by an earlier server
+// will throw Error("Could not open socket!") if the socket cannot be set up
+Command_server::Command_server(const string& socket_path, Line_handler handler_, Greeter greeter_) :
+    path(socket_path), handler(handler_), greeter(greeter_),
+    listen_fd(-1), signal_fd(-1), epoll_fd(-1), bound(false), stopping(false)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw Error(socket_error_c);
+    }
+    path.copy(address.sun_path, path.size());
+
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &saved_signal_mask);
+    signal_fd = signalfd(-1, &stop_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if(signal_fd < 0 || listen_fd < 0 || epoll_fd < 0) {
+        close_all();
+        throw Error(socket_error_c);
+    }
+    // only a socket is replaced, never some other file
+    struct stat file_status;
+    if(lstat(path.c_str(), &file_status) == 0 && S_ISSOCK(file_status.st_mode)) {
+        unlink(path.c_str());
+    }
+    if(bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close_all();
+        throw Error(socket_error_c);
+    }
+    bound = true;
+    epoll_event listen_event, signal_event;
+    listen_event.events = signal_event.events = EPOLLIN;
+    listen_event.data.fd = listen_fd;
+    signal_event.data.fd = signal_fd;
+    if(listen(listen_fd, SOMAXCONN) < 0 ||
+       epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &listen_event) < 0 ||
+       epoll_ctl(epoll_fd, EPOLL_CTL_ADD, signal_fd, &signal_event) < 0) {
+        close_all();
+        throw Error(socket_error_c);
+    }
+}
+
+// disconnect every client and remove the socket
+Command_server::~Command_server() {
+    close_all();
+}
+
+// serve clients until SIGINT or SIGTERM arrives, or stop is called
+void Command_server::run() {
+    epoll_event events[max_events_c];
+    stopping = false;
+    while(!stopping) {
+        int num_events = epoll_wait(epoll_fd, events, max_events_c, -1);
+        if(num_events < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            throw Error("Could not wait for clients!");
+        }
+        for(int i = 0; i < num_events && !stopping; ++i) {
+            int fd = events[i].data.fd;
+            if(fd == listen_fd) {
+                accept_clients();
+            } else if(fd == signal_fd) {
+                signalfd_siginfo signal_info;
+                while(read(signal_fd, &signal_info, sizeof(signal_info)) == sizeof(signal_info)) { }
+                stopping = true;
+            } else {
+                serve_client(fd, events[i].events);
+            }
+        }
+    }
+}
+
+// accept every client waiting to connect
+void Command_server::accept_clients() {
+    for(;;) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        epoll_event client_event;
+        client_event.events = EPOLLIN;
+        client_event.data.fd = fd;
+        if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &client_event) < 0) {
+            close(fd);
+            continue;
+        }
+        Client& client = clients[fd];
+        client = Client{string(), string(), 0, false, false, false};
+        greeter(client.reply);
+        if(!send_reply(fd, client)) {
+            disconnect(fd);
+            continue;
+        }
+        watch_output(fd, client, !client.reply.empty());
+    }
+}
+
+// read what the client has sent, run its complete lines, and send the replies
+/* Only one read is done each time, so that a client sending a lot does not hold
+up the others. */
+void Command_server::serve_client(int fd, unsigned int events) {
+    auto client_it = clients.find(fd);
+    if(client_it == clients.end()) {
+        return;
+    }
+    Client& client = client_it->second;
+    if(!client.watching_output && (events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+        char buffer[client_read_size_c];
+        ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+        if(count > 0) {
+            client.input.append(buffer, count);
+        } else if(count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            // what was sent last ends the last line, as the end of cin would
+            if(!client.input.empty()) {
+                client.input += '\n';
+            }
+            client.input_ended = true;
+        }
+        if(client.input.size() > max_line_length_c && client.input.find('\n') == string::npos) {
+            disconnect(fd);
+            return;
+        }
+    }
+    do {
+        handle_lines(client);
+        if(!send_reply(fd, client)) {
+            disconnect(fd);
+            return;
+        }
+    } while(client.reply.empty() && !client.closing && !stopping && client.input.find('\n') != string::npos);
+    if(client.closing && client.reply.empty()) {
+        disconnect(fd);
+        return;
+    }
+    watch_output(fd, client, !client.reply.empty());
+}
+
+// run the client's complete lines while not too much reply is waiting
+void Command_server::handle_lines(Client& client) {
+    size_t line_begin = 0;
+    string line;
+    while(!client.closing && !stopping && client.reply.size() - client.reply_sent < max_waiting_reply_c) {
+        size_t line_end = client.input.find('\n', line_begin);
+        if(line_end == string::npos) {
+            break;
+        }
+        line.assign(client.input, line_begin, line_end - line_begin);
+        line_begin = line_end + 1;
+        if(!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if(!handler(line, client.reply)) {
+            client.closing = true;
+        }
+    }
+    client.input.erase(0, line_begin);
+    if(client.input_ended && client.input.empty()) {
+        client.closing = true;
+    }
+}
+
+// send as much of the reply as the socket will take; false if the client has gone
+bool Command_server::send_reply(int fd, Client& client) {
+    while(client.reply_sent < client.reply.size()) {
+        ssize_t count = send(fd, client.reply.data() + client.reply_sent,
+                             client.reply.size() - client.reply_sent, MSG_NOSIGNAL);
+        if(count < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.reply_sent += count;
+    }
+    client.reply.clear();
+    client.reply_sent = 0;
+    return true;
+}
+
+// wait for the client's socket to take more output, or stop waiting
+/* While a reply is waiting, the client's input is not read, so that a client that
+sends commands without reading their replies is held back rather than buffered. */
+void Command_server::watch_output(int fd, Client& client, bool watch) {
+    if(client.watching_output == watch) {
+        return;
+    }
+    epoll_event client_event;
+    client_event.events = watch ? EPOLLOUT : EPOLLIN;
+    client_event.data.fd = fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &client_event);
+    client.watching_output = watch;
+}
+
+void Command_server::disconnect(int fd) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    clients.erase(fd);
+}
+
+// close the sockets and put back the signal mask
+void Command_server::close_all() {
+    for(auto& client_pair : clients) {
+        close(client_pair.first);
+    }
+    clients.clear();
+    for(int fd : {epoll_fd, listen_fd, signal_fd}) {
+        if(fd >= 0) {
+            close(fd);
+        }
+    }
+    epoll_fd = listen_fd = signal_fd = -1;
+    if(bound) {
+        unlink(path.c_str());
+        bound = false;
+    }
+    pthread_sigmask(SIG_SETMASK, &saved_signal_mask, nullptr);
+}
@@ -0,0 +1,90 @@
+/* Command_server class
+A Command_server lets many clients drive one running simulation at the same time
+through a Unix domain socket. Each client sends commands a line at a time, as they
+would be typed in, and gets back what its own commands print and nothing else.
+
+The server runs on the simulation thread: one epoll loop waits on the listening
+socket, on every connected client, and on a signalfd for SIGINT and SIGTERM, and
+all sockets are non-blocking. Text from a client is collected until a line is
+complete, and the line is then handed to the line handler, which runs it and
+returns what it printed; commands from different clients therefore never run at
+the same time, and take effect in the order their lines arrive. Replies are queued
+per client and sent as the socket will take them. While a client has a lot of
+reply waiting, the server stops running its lines until it has read some of it.
+
+SIGINT and SIGTERM are blocked in the thread that creates the server, so that they
+can be read from the signalfd instead; the server must therefore be created before
+any other thread that takes signals is started, or those threads would still be
+stopped by them.
+*/
+#ifndef COMMAND_SERVER_H
+#define COMMAND_SERVER_H
+#include <csignal>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+class Command_server {
+public:
+    // Run the commands in line, appending what they print to reply; false if the
+    // client's session should end once reply has been sent.
+    using Line_handler = std::function<bool(const std::string& line, std::string& reply)>;
+    // append what a newly connected client is first sent to reply
+    using Greeter = std::function<void(std::string& reply)>;
+
+    // listen at socket_path, replacing a socket left there by an earlier server
+    // will throw Error("Could not open socket!") if the socket cannot be set up
+    Command_server(const std::string& socket_path, Line_handler handler_, Greeter greeter_);
+    // disconnect every client and remove the socket
+    ~Command_server();
+
+    // disallow copy/move construction or assignment
+    Command_server(Command_server& other)=delete;
+    Command_server(Command_server&& other)=delete;
+    Command_server& operator=(Command_server& rhs)=delete;
+    Command_server& operator=(Command_server&& rhs)=delete;
+
+    // serve clients until SIGINT or SIGTERM arrives, or stop is called
+    void run();
+    // have run return once the line being handled is done
+    void stop()
+        {stopping = true;}
+
+private:
+    struct Client {
+        std::string input;          // text received but not yet handled
+        std::string reply;          // text not yet sent
+        std::size_t reply_sent;     // how much of reply has been sent
+        bool input_ended;           // the client has finished sending
+        bool closing;               // disconnect once reply has been sent
+        bool watching_output;       // waiting for the socket to take more, not to send more
+    };
+
+    std::string path;
+    Line_handler handler;
+    Greeter greeter;
+    int listen_fd;
+    int signal_fd;
+    int epoll_fd;
+    std::unordered_map<int, Client> clients;
+    sigset_t saved_signal_mask;
+    bool bound;                 // the socket at path is ours to remove
+    bool stopping;
+
+    // accept every client waiting to connect
+    void accept_clients();
+    // read what the client has sent, run its complete lines, and send the replies
+    void serve_client(int fd, unsigned int events);
+    // run the client's complete lines while not too much reply is waiting
+    void handle_lines(Client& client);
+    // send as much of the reply as the socket will take; false if the client has gone
+    bool send_reply(int fd, Client& client);
+    // wait for the client's socket to take more output, or stop waiting
+    void watch_output(int fd, Client& client, bool watch);
+    void disconnect(int fd);
+    // close the sockets and put back the signal mask
+    void close_all();
+};
+
+#endif
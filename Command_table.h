@@ -0,0 +1,96 @@
+/* Command_table class template
+A Command_table maps the names of a fixed set of commands to their handlers through a
+perfect hash: the table has a seed chosen so that every name hashes to a slot of its
+own, so finding a command hashes its name once and compares it with one stored name.
+Each insert searches for a new seed, growing the table if need be, which is quick for
+the few dozen names of the Controller's commands. A name can be looked up from a
+pointer and a length, so a command read in place from a buffer is not copied.
+*/
+#ifndef COMMAND_TABLE_H
+#define COMMAND_TABLE_H
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+template<typename T>
+class Command_table {
+public:
+    Command_table() : seed(0) { }
+
+    // add a command; a name already present gets the new value
+    void insert(const std::string& name, T value)
+    {
+        for(auto& entry : entries) {
+            if(entry.first == name) {
+                entry.second = value;
+                build();
+                return;
+            }
+        }
+        entries.push_back(std::make_pair(name, value));
+        build();
+    }
+    // pointer to the value for the name of length characters at name, or nullptr
+    // if it is not present
+    const T* find(const char* name, std::size_t length) const
+    {
+        if(slots.empty()) {
+            return nullptr;
+        }
+        int entry_index = slots[hash(name, length, seed) & (slots.size() - 1)];
+        if(entry_index < 0) {
+            return nullptr;
+        }
+        const std::string& entry_name = entries[entry_index].first;
+        if(entry_name.size() != length || std::memcmp(entry_name.data(), name, length) != 0) {
+            return nullptr;
+        }
+        return &entries[entry_index].second;
+    }
+    const T* find(const std::string& name) const
+        {return find(name.data(), name.size());}
+
+private:
+    std::vector<std::pair<std::string, T>> entries;
+    std::vector<int> slots;     // index into entries, or -1; the size is a power of 2
+    unsigned int seed;
+
+    // FNV-1a, starting from seed
+    static std::size_t hash(const char* name, std::size_t length, unsigned int seed_)
+    {
+        std::size_t value = 2166136261u ^ seed_;
+        for(std::size_t i = 0; i < length; ++i) {
+            value = (value ^ static_cast<unsigned char>(name[i])) * 16777619u;
+        }
+        return value;
+    }
+    // find a seed that gives every entry a slot of its own, growing the table
+    // whenever too many seeds have been tried
+    void build()
+    {
+        const unsigned int seeds_per_size_c = 1000;
+        std::size_t num_slots = 1;
+        while(num_slots < 2 * entries.size()) {
+            num_slots *= 2;
+        }
+        for(;; num_slots *= 2) {
+            for(seed = 0; seed < seeds_per_size_c; ++seed) {
+                slots.assign(num_slots, -1);
+                bool collided = false;
+                for(int entry_index = 0; entry_index < static_cast<int>(entries.size()) && !collided; ++entry_index) {
+                    const std::string& name = entries[entry_index].first;
+                    int& slot = slots[hash(name.data(), name.size(), seed) & (num_slots - 1)];
+                    collided = slot >= 0;
+                    slot = entry_index;
+                }
+                if(!collided) {
+                    return;
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -1,57 +1,143 @@
 #include "Controller.h"
 #include "Model.h"
+#include "Command_server.h"
+#include "Cruise_route_planner.h"
+#include "Event_log.h"
 #include "Views.h"
 #include "Ship.h"
 #include "Island.h"
 #include "Geometry.h"
+#include "Journal.h"
+#include "Script_reader.h"
 #include "Ship_factory.h"
 #include "Utility.h"
+#include <cctype>
+#include <climits>
+#include <cstring>
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 using std::cin;
 using std::cout;
 using std::endl;
 using std::exception;
+using std::istringstream;
+using std::memcmp;
 using std::make_shared;
 using std::shared_ptr;
 using std::string;
+using std::stringbuf;
 using std::pair;
+using std::size_t;
+using std::unique_ptr;
+using std::vector;
 
 const char* const cmdline_double_error_c = "Expected a double!";
 const char* const cmdline_unrecognized_command_c = "Unrecognized command!";
 const char* const cmdline_negative_speed_error_c = "Negative speed entered!";
-
-// Function pointer types
-using ship_fn_pair = pair<string, void(Controller::*)(shared_ptr<Ship> ship_ptr)>;
-using mv_fn_pair = pair<string, void(Controller::*)()>;
+const char* const cmdline_integer_error_c = "Expected an integer!";
+const int default_checkpoint_interval_c = 100;
+const int default_telemetry_interval_c = 1;
 
 // File static functions
-// Reads a Point from cin, ensuring valid input
-static Point read_point_from_cin() {
+// Ask for the next command
+static void print_prompt() {
+    cout << "\nTime " << Model::get_instance().get_time() << ": Enter command: ";
+}
+
+// Return s without its leading whitespace
+static string trim_leading_space(const string& s) {
+    size_t first = s.find_first_not_of(" \t\n\r");
+    return first == string::npos ? string() : s.substr(first);
+}
+
+// Reading command input
+/* Each reads from the script while one is running and from cin otherwise. They
+report what they could not read by returning false, leaving what to do about it to
+the caller. */
+
+// read the next word; false if the input has ended
+// the word is left in the script, or in word_buffer if read from cin, until the next read
+bool Controller::read_word(const char*& word, size_t& length) {
+    if(script) {
+        return script->read_word(word, length);
+    }
+    cin >> word_buffer;
+    word = word_buffer.data();
+    length = word_buffer.size();
+    return !cin.fail();
+}
+
+bool Controller::read_word(string& word) {
+    if(script) {
+        return script->read_word(word);
+    }
+    cin >> word;
+    return !cin.fail();
+}
+
+bool Controller::read_int(int& value) {
+    if(script) {
+        return script->read_int(value);
+    }
+    cin >> value;
+    return !cin.fail();
+}
+
+bool Controller::read_double(double& value) {
+    if(script) {
+        return script->read_double(value);
+    }
+    cin >> value;
+    return !cin.fail();
+}
+
+// Return true if the next thing on the current input line is a number
+bool Controller::number_follows_on_line() {
+    if(script) {
+        return script->number_follows_on_line();
+    }
+    while(cin.peek() == ' ' || cin.peek() == '\t') {
+        cin.get();
+    }
+    int next_char = cin.peek();
+    return isdigit(next_char) || next_char == '-' || next_char == '+';
+}
+
+// Reads a Point, ensuring valid input
+Point Controller::read_point() {
     double x, y;
-    cin >> x;
-    if(cin.fail())
+    if(!read_double(x))
         throw Error(cmdline_double_error_c);
-    cin >> y;
-    if(cin.fail())
+    if(!read_double(y))
         throw Error(cmdline_double_error_c);
     return Point(x, y);
 }
 
+// Reads "on" or "off" and returns true for on
+bool Controller::read_on_off() {
+    string setting;
+    read_word(setting);
+    if(setting == "on")
+        return true;
+    if(setting != "off")
+        throw Error("Expected on or off!");
+    return false;
+}
+
 // Helper functions (commands to be run)
 
 // Set Course and Speed of a Ship
 void Controller::set_course_and_speed(shared_ptr<Ship> ship_ptr) {
     double course, speed;
-    cin >> course;
-    if(cin.fail())
+    if(!read_double(course))
         throw Error(cmdline_double_error_c);
     if(course < 0.0 || course >= 360.0)
         throw Error("Invalid heading entered!");
-    cin >> speed;
-    if(cin.fail())
+    if(!read_double(speed))
         throw Error(cmdline_double_error_c);
     if(speed < 0)
         throw Error(cmdline_negative_speed_error_c);
@@ -60,10 +146,9 @@ void Controller::set_course_and_speed(shared_ptr<Ship> ship_ptr) {
 
 // Set Destination Position and Speed for a Ship
 void Controller::set_destination_position_and_speed(shared_ptr<Ship> ship_ptr) {
-    Point position_point = read_point_from_cin();
+    Point position_point = read_point();
     double speed;
-    cin >> speed;
-    if(cin.fail())
+    if(!read_double(speed))
         throw Error(cmdline_double_error_c);
     if(speed < 0)
         throw Error(cmdline_negative_speed_error_c);
@@ -73,10 +158,9 @@ void Controller::set_destination_position_and_speed(shared_ptr<Ship> ship_ptr) {
 // Set Island Destination for a Ship
 void Controller::set_island_destination(shared_ptr<Ship> ship_ptr) {
     string island_name;
-    cin >> island_name;
+    read_word(island_name);
     double speed;
-    cin >> speed;
-    if(cin.fail())
+    if(!read_double(speed))
         throw Error(cmdline_double_error_c);
     if(speed < 0)
         throw Error(cmdline_negative_speed_error_c);
@@ -87,7 +171,7 @@ void Controller::set_island_destination(shared_ptr<Ship> ship_ptr) {
 // Set where Ship will load at
 void Controller::set_load_at(shared_ptr<Ship> ship_ptr) {
     string island_name;
-    cin >> island_name;
+    read_word(island_name);
     shared_ptr<Island> island_to_load_at = Model::get_instance().get_island_ptr(island_name);
     ship_ptr->set_load_destination(island_to_load_at);
 }
@@ -95,7 +179,7 @@ void Controller::set_load_at(shared_ptr<Ship> ship_ptr) {
 // Set where Ship will unload at
 void Controller::set_unload_at(shared_ptr<Ship> ship_ptr) {
     string island_name;
-    cin >> island_name;
+    read_word(island_name);
     shared_ptr<Island> island_to_unload_at = Model::get_instance().get_island_ptr(island_name);
     ship_ptr->set_unload_destination(island_to_unload_at);
 }
@@ -103,7 +187,7 @@ void Controller::set_unload_at(shared_ptr<Ship> ship_ptr) {
 // Set where Ship will dock at
 void Controller::dock_at(shared_ptr<Ship> ship_ptr) {
     string island_name;
-    cin >> island_name;
+    read_word(island_name);
     shared_ptr<Island> island_to_dock_at = Model::get_instance().get_island_ptr(island_name);
     ship_ptr->dock(island_to_dock_at);
 }
@@ -111,7 +195,7 @@ void Controller::dock_at(shared_ptr<Ship> ship_ptr) {
 // Have a Ship attack another Ship
 void Controller::attack(shared_ptr<Ship> ship_ptr) {
     string ship_to_attack;
-    cin >> ship_to_attack;
+    read_word(ship_to_attack);
     shared_ptr<Ship> ship_to_attack_ptr = Model::get_instance().get_ship_ptr(ship_to_attack);
     ship_ptr->attack(ship_to_attack_ptr);
 }
@@ -146,9 +230,8 @@ void Controller::set_size() {
         throw Error("Map view is not open!");
     }
     int size;
-    cin >> size;
-    if(cin.fail())
-        throw Error("Expected an integer!");
+    if(!read_int(size))
+        throw Error(cmdline_integer_error_c);
     mapview_ptr->set_size(size);
 }
 
@@ -158,8 +241,7 @@ void Controller::set_zoom() {
         throw Error("Map view is not open!");
     }
     double zoom;
-    cin >> zoom;
-    if(cin.fail())
+    if(!read_double(zoom))
         throw Error(cmdline_double_error_c);
     mapview_ptr->set_scale(zoom);
 }
@@ -169,7 +251,7 @@ void Controller::set_pan() {
     if(!mapview_ptr) {
         throw Error("Map view is not open!");
     }
-     Point pan_point = read_point_from_cin();
+     Point pan_point = read_point();
      mapview_ptr->set_origin(pan_point);
 }
 
@@ -183,17 +265,66 @@ void Controller::status() {
     Model::get_instance().describe();
 }
 
-// Update all Sim_objects
+// Update all Sim_objects, optionally a given number of times
+// "go <n>" holds back View updates until all n are done
 void Controller::go() {
-    Model::get_instance().update();
+    if(!number_follows_on_line()) {
+        Model::get_instance().update();
+        return;
+    }
+    int num_ticks;
+    if(!read_int(num_ticks))
+        throw Error(cmdline_integer_error_c);
+    if(num_ticks < 1)
+        throw Error("Number of updates must be positive!");
+    Model::get_instance().fast_forward(num_ticks);
+}
+
+// Turn the messages printed during updates on or off
+void Controller::set_events() {
+    Model::get_instance().set_console_events(read_on_off());
+}
+
+// Set which events are printed: 0 for none, 1 for notices only, 2 for all
+void Controller::set_verbosity() {
+    int verbosity;
+    if(!read_int(verbosity))
+        throw Error(cmdline_integer_error_c);
+    Event_log::get_instance().set_verbosity(verbosity);
+}
+
+// Turn printing the events of one category on or off
+void Controller::set_event_category() {
+    string category_name;
+    read_word(category_name);
+    Event_category_e category = Event_log::get_category(category_name);
+    Event_log::get_instance().set_muted(category, !read_on_off());
+}
+
+// Turn skipping over uneventful ticks during 'go <n>' on or off
+// Only takes effect while events are off.
+void Controller::set_time_skipping() {
+    Model::get_instance().set_time_skipping(read_on_off());
+}
+
+// Turn improving planned cruise tours with 2-opt on or off
+// Only cruises started afterwards are affected.
+void Controller::set_tour_improving() {
+    Cruise_route_planner::get_instance().set_improving(read_on_off());
+}
+
+// Turn resolving each tick's shots all together on or off
+void Controller::set_batched_combat() {
+    Model::get_instance().set_batched_combat(read_on_off());
 }
 
 // Create a new Ship
 void Controller::create() {
     string input, type;
     double x, y;
-    cin >> input >> type >> x >> y;
-    if(cin.fail())
+    read_word(input);
+    read_word(type);
+    if(!read_double(x) || !read_double(y))
         throw Error(cmdline_double_error_c);
     if(input.size() < 2)
         throw Error("Name is too short!");
@@ -203,6 +334,151 @@ void Controller::create() {
     Model::get_instance().add_ship(new_ship);
 }
 
+// Set the number of threads used to update the simulation
+void Controller::set_threads() {
+    int num_threads;
+    if(!read_int(num_threads))
+        throw Error(cmdline_integer_error_c);
+    if(num_threads < 1)
+        throw Error("Number of threads must be positive!");
+    Model::get_instance().set_worker_threads(num_threads);
+}
+
+// Write the state of the simulation to a snapshot file
+void Controller::save() {
+    string filename;
+    read_word(filename);
+    Model::get_instance().save(filename);
+}
+
+// Replace the state of the simulation with that in a snapshot file
+void Controller::load() {
+    string filename;
+    read_word(filename);
+    Model::get_instance().load(filename);
+}
+
+// Replace all objects with those described in a scenario file
+void Controller::load_scenario() {
+    string filename;
+    read_word(filename);
+    Model::get_instance().load_scenario(filename);
+}
+
+/* Start recording accepted commands to a journal file, with a checkpoint every
+ <interval> ticks (100 if not given). Error: journal is already open. */
+void Controller::open_journal() {
+    if(journal)
+        throw Error("Journal is already open!");
+    string filename;
+    read_word(filename);
+    int checkpoint_interval = default_checkpoint_interval_c;
+    if(number_follows_on_line()) {
+        if(!read_int(checkpoint_interval))
+            throw Error(cmdline_integer_error_c);
+        if(checkpoint_interval < 1)
+            throw Error("Checkpoint interval must be positive!");
+    }
+    journal.reset(new Journal(filename, checkpoint_interval));
+    // a running script keeps track of the text of its own commands
+    if(!script) {
+        recorder.reset(new Recording_streambuf(cin.rdbuf()));
+        cin.rdbuf(recorder.get());
+    }
+}
+
+/* Stop recording commands. Error: no journal is open. */
+void Controller::close_journal() {
+    if(!journal)
+        throw Error("No journal is open!");
+    stop_recording();
+    journal.reset();
+}
+
+/* Run the commands in a journal file again, without any output. With a <time>,
+ start from the latest checkpoint at or before it and stop before the first
+ command given at or after it; otherwise start from the first checkpoint and run
+ them all. Errors: journal is open; no checkpoint at or before <time>. */
+void Controller::replay() {
+    if(journal)
+        throw Error("Journal is open!");
+    string filename;
+    read_word(filename);
+    int stop_time = INT_MAX;
+    if(number_follows_on_line()) {
+        if(!read_int(stop_time))
+            throw Error(cmdline_integer_error_c);
+    }
+    vector<Journal_entry> entries = read_journal(filename);
+    size_t start = entries.size();
+    for(size_t i = 0; i < entries.size(); ++i) {
+        if(entries[i].kind != Journal_entry::Kind_e::CHECKPOINT || entries[i].time > stop_time)
+            continue;
+        start = i;
+        if(stop_time == INT_MAX)
+            break;
+    }
+    if(start == entries.size())
+        throw Error("No checkpoint at or before that time!");
+
+    Model& model = Model::get_instance();
+    model.load(entries[start].text);
+    model.set_console_events(entries[start].console_events);
+    model.set_time_skipping(entries[start].time_skipping);
+    Cruise_route_planner::get_instance().set_improving(entries[start].tour_improving);
+    model.set_batched_combat(entries[start].batched_combat);
+
+    Null_streambuf discard;
+    Cout_redirect quiet(&discard);
+    std::streambuf* saved_cin_buffer = cin.rdbuf();
+    // the journaled commands are read from cin, even while a script is running
+    Script_reader* saved_script = script;
+    script = nullptr;
+    try {
+        for(size_t i = start + 1; i < entries.size(); ++i) {
+            if(entries[i].kind != Journal_entry::Kind_e::COMMAND)
+                continue;
+            if(entries[i].time >= stop_time)
+                break;
+            istringstream command_stream(entries[i].text);
+            cin.rdbuf(command_stream.rdbuf());
+            // a command that failed when replayed failed the same way when recorded
+            try {
+                string input;
+                read_word(input);
+                run_command(input);
+            } catch(Error&) { }
+            cin.clear();
+        }
+    } catch(...) {
+        cin.rdbuf(saved_cin_buffer);
+        script = saved_script;
+        throw;
+    }
+    cin.rdbuf(saved_cin_buffer);
+    script = saved_script;
+}
+
+/* Record the state of every object to a telemetry file every <interval> ticks
+ (every tick if not given). Error: telemetry is already open. */
+void Controller::open_telemetry() {
+    string filename;
+    read_word(filename);
+    int interval = default_telemetry_interval_c;
+    if(number_follows_on_line()) {
+        if(!read_int(interval))
+            throw Error(cmdline_integer_error_c);
+        if(interval < 1)
+            throw Error("Telemetry interval must be positive!");
+    }
+    Model::get_instance().open_telemetry(filename, interval);
+}
+
+/* Finish the telemetry file. Error: no telemetry is open. */
+void Controller::close_telemetry() {
+    Model::get_instance().close_telemetry();
+}
+
 /* - create and open the map view. The Project 4 view commands size, zoom, and 
  pan control this view if it is open. Error: map view is already open. */
 void Controller::open_map_view() {
@@ -253,7 +529,7 @@ void Controller::close_sailing_view() {
  order of checks: no ship of that name; bridge view is already open for that ship.*/
 void Controller::open_bridge_view() {
     string shipname;
-    cin >> shipname;
+    read_word(shipname);
     if(!Model::get_instance().is_name_in_use(shipname)) {
         throw Error("Ship not found!");
     }
@@ -270,7 +546,7 @@ void Controller::open_bridge_view() {
 /* Close a bridge view for ship with name shipname */
 void Controller::close_bridge_view() {
     string shipname;
-    cin >> shipname;
+    read_word(shipname);
     auto bridgeview_it = bridgeview_map.find(shipname);
     if(bridgeview_it == bridgeview_map.end()) {
         throw Error("Bridge view for that ship is not open!");
@@ -284,7 +560,7 @@ void Controller::close_bridge_view() {
  order of checks: no object of that name; objectview is already open for that object.*/
 void Controller::open_object_view() {
     string objectname;
-    cin >> objectname;
+    read_word(objectname);
     if(!(Model::get_instance().is_ship_present(objectname) || Model::get_instance().is_island_present(objectname))) {
         throw Error("Object not found!");
     }
@@ -301,7 +577,7 @@ void Controller::open_object_view() {
 /* Close a objectview for object with name objectname */
 void Controller::close_object_view() {
     string objectname;
-    cin >> objectname;
+    read_word(objectname);
     auto objectview_it = objectview_map.find(objectname);
     if(objectview_it == objectview_map.end()) {
         throw Error("Object view for that object is not open!");
@@ -312,62 +588,74 @@ void Controller::close_object_view() {
 }
 
 // output constructor message
-Controller::Controller() {
-    ship_commands.insert(ship_fn_pair("course", &Controller::set_course_and_speed));
-    ship_commands.insert(ship_fn_pair("position", &Controller::set_destination_position_and_speed));
-    ship_commands.insert(ship_fn_pair("destination", &Controller::set_island_destination));
-    ship_commands.insert(ship_fn_pair("load_at", &Controller::set_load_at));
-    ship_commands.insert(ship_fn_pair("unload_at", &Controller::set_unload_at));
-    ship_commands.insert(ship_fn_pair("dock_at", &Controller::dock_at));
-    ship_commands.insert(ship_fn_pair("attack", &Controller::attack));
-    ship_commands.insert(ship_fn_pair("refuel", &Controller::refuel));
-    ship_commands.insert(ship_fn_pair("stop", &Controller::stop));
-    ship_commands.insert(ship_fn_pair("stop_attack", &Controller::stop_attack));
+Controller::Controller() : script(nullptr) {
+    ship_commands.insert("course", &Controller::set_course_and_speed);
+    ship_commands.insert("position", &Controller::set_destination_position_and_speed);
+    ship_commands.insert("destination", &Controller::set_island_destination);
+    ship_commands.insert("load_at", &Controller::set_load_at);
+    ship_commands.insert("unload_at", &Controller::set_unload_at);
+    ship_commands.insert("dock_at", &Controller::dock_at);
+    ship_commands.insert("attack", &Controller::attack);
+    ship_commands.insert("refuel", &Controller::refuel);
+    ship_commands.insert("stop", &Controller::stop);
+    ship_commands.insert("stop_attack", &Controller::stop_attack);
     
-    mv_commands.insert(mv_fn_pair("default", &Controller::set_defaults));
-    mv_commands.insert(mv_fn_pair("size", &Controller::set_size));
-    mv_commands.insert(mv_fn_pair("zoom", &Controller::set_zoom));
-    mv_commands.insert(mv_fn_pair("pan", &Controller::set_pan));
-    mv_commands.insert(mv_fn_pair("show", &Controller::show));
-    mv_commands.insert(mv_fn_pair("status", &Controller::status));
-    mv_commands.insert(mv_fn_pair("go", &Controller::go));
-    mv_commands.insert(mv_fn_pair("create", &Controller::create));
+    mv_commands.insert("default", &Controller::set_defaults);
+    mv_commands.insert("size", &Controller::set_size);
+    mv_commands.insert("zoom", &Controller::set_zoom);
+    mv_commands.insert("pan", &Controller::set_pan);
+    mv_commands.insert("show", &Controller::show);
+    mv_commands.insert("status", &Controller::status);
+    mv_commands.insert("go", &Controller::go);
+    mv_commands.insert("events", &Controller::set_events);
+    mv_commands.insert("verbosity", &Controller::set_verbosity);
+    mv_commands.insert("log", &Controller::set_event_category);
+    mv_commands.insert("skip", &Controller::set_time_skipping);
+    mv_commands.insert("improve_tours", &Controller::set_tour_improving);
+    mv_commands.insert("batch_combat", &Controller::set_batched_combat);
+    mv_commands.insert("create", &Controller::create);
+    mv_commands.insert("threads", &Controller::set_threads);
+    mv_commands.insert("save", &Controller::save);
+    mv_commands.insert("load", &Controller::load);
+    mv_commands.insert("scenario", &Controller::load_scenario);
+    mv_commands.insert("open_journal", &Controller::open_journal);
+    mv_commands.insert("close_journal", &Controller::close_journal);
+    mv_commands.insert("replay", &Controller::replay);
+    mv_commands.insert("open_telemetry", &Controller::open_telemetry);
+    mv_commands.insert("close_telemetry", &Controller::close_telemetry);
     
-    mv_commands.insert(mv_fn_pair("open_map_view", &Controller::open_map_view));
-    mv_commands.insert(mv_fn_pair("close_map_view", &Controller::close_map_view));
-    mv_commands.insert(mv_fn_pair("open_sailing_view", &Controller::open_sailing_view));
-    mv_commands.insert(mv_fn_pair("close_sailing_view", &Controller::close_sailing_view));
-    mv_commands.insert(mv_fn_pair("open_bridge_view", &Controller::open_bridge_view));
-    mv_commands.insert(mv_fn_pair("close_bridge_view", &Controller::close_bridge_view));
-    mv_commands.insert(mv_fn_pair("open_object_view", &Controller::open_object_view));
-    mv_commands.insert(mv_fn_pair("close_object_view", &Controller::close_object_view));
+    mv_commands.insert("open_map_view", &Controller::open_map_view);
+    mv_commands.insert("close_map_view", &Controller::close_map_view);
+    mv_commands.insert("open_sailing_view", &Controller::open_sailing_view);
+    mv_commands.insert("close_sailing_view", &Controller::close_sailing_view);
+    mv_commands.insert("open_bridge_view", &Controller::open_bridge_view);
+    mv_commands.insert("close_bridge_view", &Controller::close_bridge_view);
+    mv_commands.insert("open_object_view", &Controller::open_object_view);
+    mv_commands.insert("close_object_view", &Controller::close_object_view);
 }
 
+// defined where Journal and Recording_streambuf are complete
+Controller::~Controller() {}
+
 // create View object, run the program by acccepting user commands, then destroy View object
 void Controller::run() {
     Model::get_instance(); // instantiate the Model
 
-    cout << "\nTime " << Model::get_instance().get_time() << ": Enter command: ";
+    print_prompt();
     
     string input;
-    cin >> input;
+    read_word(input);
     while(input != "quit") {
+        // only commands given while the journal was already open are recorded,
+        // not the ones that open or close it
+        bool journaling = bool(journal);
+        int command_time = Model::get_instance().get_time();
+        // run_command only throws from a command's handler
+        bool dispatched = true;
         try {
-            // First see if we've gotten a Ship command
-            if(Model::get_instance().is_ship_present(input)) {
-                string command;
-                cin >> command;
-                shared_ptr<Ship> ship_ptr = Model::get_instance().get_ship_ptr(input);
-                auto str_ship_pair = ship_commands.find(command);
-                if(str_ship_pair == ship_commands.end())
-                    throw Error(cmdline_unrecognized_command_c);
-                (this->*str_ship_pair->second)(ship_ptr);
-            } // Then look for a Model/View command
-                else {
-                auto str_fn_pair = mv_commands.find(input);
-                if(str_fn_pair == mv_commands.end())
-                    throw Error(cmdline_unrecognized_command_c);
-                (this->*str_fn_pair->second)();
+            if(!run_command(input)) {
+                dispatched = false;
+                throw Error(cmdline_unrecognized_command_c);
             }
         } catch(Error& e) {
             cout << e.what() << endl;
@@ -378,10 +666,166 @@ void Controller::run() {
             cout << se.what() << endl;
             break; // Exit the loop and program
         }
-        cout << "\nTime " << Model::get_instance().get_time() << ": Enter command: ";
-        cin >> input;
+        if(recorder) {
+            string command_text = trim_leading_space(recorder->take_recorded());
+            if(dispatched && journaling && journal)
+                record_command(command_time, command_text);
+        }
+        print_prompt();
+        read_word(input);
     }
+    stop_recording();
     cout <<  "Done" << endl;
     return;
 
 }
+
+// Run the commands in a script file as they would be run if typed in, until quit
+// or the end of the file
+/* The script is read in place (see Script_reader), and the commands are dispatched
+without the errors of reading them or of finding them being thrown; only errors
+found by the commands themselves are. */
+void Controller::run_script(const string& filename) {
+    Model::get_instance(); // instantiate the Model
+
+    unique_ptr<Script_reader> reader;
+    try {
+        reader.reset(new Script_reader(filename));
+    } catch(Error& e) {
+        cout << e.what() << endl;
+        return;
+    }
+    script = reader.get();
+    print_prompt();
+    try {
+        run_script_commands();
+    } catch(std::exception& se) {
+        cout << se.what() << endl;
+    }
+    script = nullptr;
+    cout <<  "Done" << endl;
+}
+
+// Serve clients connecting to a Unix domain socket at socket_path until SIGINT or
+// SIGTERM arrives (see Command_server); each line a client sends is run as a script
+// of one line, and what it prints is sent back to that client
+void Controller::serve(const string& socket_path) {
+    unique_ptr<Command_server> server;
+    try {
+        server.reset(new Command_server(socket_path,
+            [this](const string& line, string& reply) {return serve_line(line, reply);},
+            [](string& reply) {
+                stringbuf prompt;
+                Cout_redirect to_client(&prompt);
+                print_prompt();
+                reply += prompt.str();
+            }));
+    } catch(Error& e) {
+        cout << e.what() << endl;
+        return;
+    }
+    // the Model starts threads, so it must come after the server blocks its signals
+    Model::get_instance(); // instantiate the Model
+    try {
+        server->run();
+    } catch(std::exception& se) {
+        cout << se.what() << endl;
+    }
+    server.reset();
+    cout <<  "Done" << endl;
+}
+
+// Run the commands in the script until it ends or one is quit, printing the prompt
+// after each; false if one was quit
+bool Controller::run_script_commands() {
+    const char* word;
+    size_t length;
+    string input;
+    while(script->read_word(word, length)) {
+        if(length == 4 && memcmp(word, "quit", 4) == 0)
+            return false;
+        input.assign(word, length);
+        bool journaling = bool(journal);
+        int command_time = Model::get_instance().get_time();
+        // run_command only throws from a command's handler
+        bool dispatched = true;
+        try {
+            if(!run_command(input)) {
+                dispatched = false;
+                cout << cmdline_unrecognized_command_c << endl;
+                script->skip_line();
+            }
+        } catch(Error& e) {
+            cout << e.what() << endl;
+            script->skip_line();
+        }
+        if(dispatched && journaling && journal)
+            record_command(command_time, string(word, script->get_position()));
+        print_prompt();
+    }
+    return true;
+}
+
+// Run the commands in a line sent by a client, appending what they print to reply;
+// false if one of them is quit
+bool Controller::serve_line(const string& line, string& reply) {
+    Script_reader line_reader(line.data(), line.size());
+    stringbuf output;
+    bool quit;
+    {
+        Cout_redirect to_client(&output);
+        script = &line_reader;
+        try {
+            quit = !run_script_commands();
+        } catch(...) {
+            script = nullptr;
+            throw;
+        }
+        script = nullptr;
+    }
+    reply += output.str();
+    return !quit;
+}
+
+// Run the command whose first word is input, reading the rest of it from the input;
+// false if there is no such command
+bool Controller::run_command(const string& input) {
+    // First see if we've gotten a Ship command
+    if(shared_ptr<Ship> ship_ptr = Model::get_instance().find_ship(input)) {
+        const char* command;
+        size_t length;
+        read_word(command, length);
+        Model::get_instance().wake(ship_ptr);
+        auto ship_command = ship_commands.find(command, length);
+        if(!ship_command)
+            return false;
+        (this->*(*ship_command))(ship_ptr);
+    } // Then look for a Model/View command
+        else {
+        auto mv_command = mv_commands.find(input);
+        if(!mv_command)
+            return false;
+        (this->*(*mv_command))();
+    }
+    return true;
+}
+
+// journal the text of a command that reached its handler, whether or not it
+// failed, and print the Error if the journal cannot be written
+/* A command can change the simulation before it fails, so a failed command has to
+be replayed too; replay lets it fail again the same way. */
+void Controller::record_command(int command_time, const string& command_text) {
+    try {
+        journal->record_command(command_time, command_text);
+    } catch(Error& e) {
+        cout << e.what() << endl;
+    }
+}
+
+// take cin back from the Recording_streambuf, if it has it
+void Controller::stop_recording() {
+    if(!recorder)
+        return;
+    cin.rdbuf(recorder->release_source());
+    recorder.reset();
+}
@@ -4,8 +4,11 @@ with the user.
 */
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
+#include "Command_table.h"
+#include <cstddef>
 #include <map>
 #include <memory>
+#include <string>
 class Model;
 class View;
 class Ship;
@@ -14,22 +17,73 @@ class MapView;
 class SailingView;
 class BridgeView;
 class ObjectView;
+class Journal;
+class Recording_streambuf;
+class Script_reader;
+struct Point;
 
 class Controller {
 public:	
 	// output constructor message
 	Controller();
+    // defined where Journal and Recording_streambuf are complete
+    ~Controller();
     
 	// create View object, run the program by acccepting user commands, then destroy View object
 	void run();
+    // run the commands in a script file as they would be run if typed in, until
+    // quit or the end of the file
+    void run_script(const std::string& filename);
+    // serve clients connecting to a Unix domain socket at socket_path until SIGINT
+    // or SIGTERM arrives, sending each what its own commands print
+    void serve(const std::string& socket_path);
     
 private:
     std::shared_ptr<MapView> mapview_ptr;
     std::shared_ptr<SailingView> sailview_ptr;
     std::map<std::string, std::shared_ptr<BridgeView>> bridgeview_map;
     std::map<std::string, std::shared_ptr<ObjectView>> objectview_map;
-    std::map<std::string, void(Controller::*)(std::shared_ptr<Ship> ship_ptr)> ship_commands;
-    std::map<std::string, void(Controller::*)()> mv_commands;
+    Command_table<void(Controller::*)(std::shared_ptr<Ship> ship_ptr)> ship_commands;
+    Command_table<void(Controller::*)()> mv_commands;
+    // while a journal is open, cin reads through recorder so that the text of
+    // each command can be journaled
+    std::unique_ptr<Journal> journal;
+    std::unique_ptr<Recording_streambuf> recorder;
+    // the script being run, or nullptr if commands are read from cin
+    Script_reader* script;
+    // holds the last word read by read_word from cin
+    std::string word_buffer;
+    
+    // Run the command whose first word is input, reading the rest of it from the input;
+    // false if there is no such command
+    bool run_command(const std::string& input);
+    // Run the commands in the script until it ends or one is quit, printing the
+    // prompt after each; false if one was quit
+    bool run_script_commands();
+    // Run the commands in a line sent by a client, appending what they print to reply;
+    // false if one of them is quit
+    bool serve_line(const std::string& line, std::string& reply);
+    // journal the text of a command that reached its handler, whether or not it
+    // failed, and print the Error if the journal cannot be written
+    void record_command(int command_time, const std::string& command_text);
+    // take cin back from the Recording_streambuf, if it has it
+    void stop_recording();
+    
+    // Reading command input, from the script if one is running and from cin otherwise;
+    // each returns false if the input does not hold what is asked for
+    
+    // read the next word; false if the input has ended
+    // the word is left in the script, or in word_buffer if read from cin, until the next read
+    bool read_word(const char*& word, std::size_t& length);
+    bool read_word(std::string& word);
+    bool read_int(int& value);
+    bool read_double(double& value);
+    // Return true if the next thing on the current input line is a number
+    bool number_follows_on_line();
+    // Reads a Point, ensuring valid input
+    Point read_point();
+    // Reads "on" or "off" and returns true for on
+    bool read_on_off();
     
     // Helper Commands
     // Ship Commands
@@ -69,10 +123,45 @@ private:
     void show();
     // Output status of all Sim_objects
     void status();
-    // Update all Sim_objects
+    // Update all Sim_objects, optionally a given number of times
     void go();
+    // Turn the messages printed during updates on or off
+    void set_events();
+    // Set which events are printed: 0 for none, 1 for notices only, 2 for all
+    void set_verbosity();
+    // Turn printing the events of one category on or off
+    void set_event_category();
+    // Turn skipping over uneventful ticks during 'go <n>' on or off
+    void set_time_skipping();
+    // Turn improving planned cruise tours with 2-opt on or off
+    void set_tour_improving();
+    // Turn resolving each tick's shots all together on or off
+    void set_batched_combat();
     // Create a new Ship
     void create();
+    // Set the number of threads used to update the simulation
+    void set_threads();
+    // Write the state of the simulation to a snapshot file
+    void save();
+    // Replace the state of the simulation with that in a snapshot file
+    void load();
+    // Replace all objects with those described in a scenario file
+    void load_scenario();
+    /* Start recording accepted commands to a journal file, with a checkpoint every
+     <interval> ticks (100 if not given). Error: journal is already open. */
+    void open_journal();
+    /* Stop recording commands. Error: no journal is open. */
+    void close_journal();
+    /* Run the commands in a journal file again, without any output. With a <time>,
+     start from the latest checkpoint at or before it and stop before the first
+     command given at or after it; otherwise start from the first checkpoint and run
+     them all. Errors: journal is open; no checkpoint at or before <time>. */
+    void replay();
+    /* Record the state of every object to a telemetry file every <interval> ticks
+     (every tick if not given). Error: telemetry is already open. */
+    void open_telemetry();
+    /* Finish the telemetry file. Error: no telemetry is open. */
+    void close_telemetry();
     
     // View subclass Commands
     /* - create and open the map view. The Project 4 view commands size, zoom, and
@@ -0,0 +1,120 @@
+#include "Cruise_route_planner.h"
+#include "Island.h"
+#include "Geometry.h"
+#include "Model.h"
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+using std::async;
+using std::launch;
+using std::make_pair;
+using std::make_shared;
+using std::move;
+using std::promise;
+using std::reverse;
+using std::shared_future;
+using std::shared_ptr;
+using std::vector;
+
+// a 2-opt move must shorten the tour by more than this, in nm, to be made
+const double route_improvement_min_c = 1e-9;
+// at most this many passes are made over a tour, each trying every 2-opt move
+const int route_improvement_max_passes_c = 50;
+
+// static method to get the instance of Cruise_route_planner
+Cruise_route_planner& Cruise_route_planner::get_instance() {
+    static Cruise_route_planner planner;
+    return planner;
+}
+
+// the tour starting at the Island with index start in the Edition islands,
+// which must be the Model's current one
+/* The cache only keeps the tours of one Edition, and is emptied when asked about
+another; the Islands change rarely, and Cruise_ships on an older Edition already
+have their tours. */
+Cruise_route_planner::Route_ticket Cruise_route_planner::get_route(
+    shared_ptr<const Island_catalog::Edition> islands, int start) {
+    if(islands->get_version() != cached_version) {
+        cached_routes.clear();
+        cached_version = islands->get_version();
+    }
+    auto cached_it = cached_routes.find(make_pair(start, improving));
+    if(cached_it != cached_routes.end()) {
+        return cached_it->second;
+    }
+    shared_ptr<const Route> greedy_route = plan_greedy(islands, start);
+    Route_ticket ticket;
+    if(improving) {
+        vector<Point> locations;
+        for(const auto& island_ptr : islands->get_islands()) {
+            locations.push_back(island_ptr->get_location());
+        }
+        shared_future<vector<int>> improved_stops =
+            async(launch::async, &Cruise_route_planner::improve, greedy_route->stops, move(locations)).share();
+        // the Route is put together by whoever waits for it, on the simulation thread
+        ticket = async(launch::deferred, [islands, improved_stops]() -> shared_ptr<const Route>
+                            { return make_shared<Route>(Route{islands, improved_stops.get()}); }).share();
+    } else {
+        promise<shared_ptr<const Route>> planned;
+        planned.set_value(greedy_route);
+        ticket = planned.get_future().share();
+    }
+    cached_routes[make_pair(start, improving)] = ticket;
+    return ticket;
+}
+
+// each leg to the nearest Island not yet visited, as the Model finds it
+shared_ptr<const Cruise_route_planner::Route> Cruise_route_planner::plan_greedy(
+    shared_ptr<const Island_catalog::Edition> islands, int start) {
+    shared_ptr<Route> route = make_shared<Route>();
+    route->islands = islands;
+    int num_islands = static_cast<int>(islands->get_islands().size());
+    vector<bool> visited(num_islands, false);
+    visited[start] = true;
+    route->stops.reserve(num_islands);
+    route->stops.push_back(start);
+    for(int num_stops = 1; num_stops < num_islands; ++num_stops) {
+        Point location = islands->get_islands()[route->stops.back()]->get_location();
+        shared_ptr<Island> next_ptr = Model::get_instance().nearest_island(location,
+            [&islands, &visited](const shared_ptr<Island>& island_ptr)
+                {
+                    int index = islands->find_index(*island_ptr);
+                    return index < 0 || visited[index];
+                });
+        if(!next_ptr) {
+            break;
+        }
+        int next = islands->find_index(*next_ptr);
+        visited[next] = true;
+        route->stops.push_back(next);
+    }
+    return route;
+}
+
+// shorten a tour by reversing parts of it while that helps; locations are those
+// of the Edition's Islands, by index
+/* The tour is a closed loop back to the start, which stays first. Reversing
+stops i..k replaces the legs (i-1, i) and (k, k+1) with (i-1, k) and (i, k+1). */
+vector<int> Cruise_route_planner::improve(vector<int> stops, vector<Point> locations) {
+    int num_stops = static_cast<int>(stops.size());
+    auto leg = [&locations](int from, int to)
+        { return cartesian_distance(locations[from], locations[to]); };
+    bool changed = true;
+    for(int pass = 0; changed && pass < route_improvement_max_passes_c; ++pass) {
+        changed = false;
+        for(int i = 1; i < num_stops - 1; ++i) {
+            for(int k = i + 1; k < num_stops; ++k) {
+                int before = stops[i - 1], after = stops[(k + 1) % num_stops];
+                double saving = leg(before, stops[i]) + leg(stops[k], after)
+                              - leg(before, stops[k]) - leg(stops[i], after);
+                if(saving > route_improvement_min_c) {
+                    reverse(stops.begin() + i, stops.begin() + k + 1);
+                    changed = true;
+                }
+            }
+        }
+    }
+    return stops;
+}
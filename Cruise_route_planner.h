@@ -0,0 +1,73 @@
+/* Cruise_route_planner class
+The Cruise_route_planner works out the whole tour of a cruise at once: the order in
+which a Cruise_ship starting from a given Island visits every other Island of an
+Edition (see Island_catalog) before going back. Many Cruise_ships start from the
+same Island, so each tour is worked out only once for each start Island and Edition,
+and then shared by every Cruise_ship on it.
+
+By default a tour is planned greedily: each leg goes to the Island not yet visited
+that Model::nearest_island picks, exactly as a Cruise_ship would choose them one leg
+at a time. Improving can be turned on, and then each
+greedy tour is also shortened with a 2-opt pass on a background thread. The
+Cruise_ship only waits for it when it leaves its first Island, if it is not done by
+then. Improved tours visit the Islands in a different order than the greedy ones,
+so their output differs; improving is off unless asked for. The background work is
+given only the stops and the Islands' locations, never the Edition, so that it can
+never be left holding the last reference to pooled Islands (see Object_pool.h).
+
+The planner is not thread-safe apart from its background work; only the thread
+running the simulation may use it.
+*/
+#ifndef CRUISE_ROUTE_PLANNER_H
+#define CRUISE_ROUTE_PLANNER_H
+#include "Island_catalog.h"
+#include <future>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Cruise_route_planner {
+public:
+    // a tour, as indexes of Islands of an Edition; the first is the start Island
+    struct Route {
+        std::shared_ptr<const Island_catalog::Edition> islands;
+        std::vector<int> stops;
+    };
+    // a Route that may still be being improved; get() waits for it
+    using Route_ticket = std::shared_future<std::shared_ptr<const Route>>;
+
+    // static method to get the instance of Cruise_route_planner
+    static Cruise_route_planner& get_instance();
+
+    // disallow copy/move construction or assignment
+    Cruise_route_planner(Cruise_route_planner& other)=delete;
+    Cruise_route_planner(Cruise_route_planner&& other)=delete;
+    Cruise_route_planner& operator=(Cruise_route_planner& rhs)=delete;
+    Cruise_route_planner& operator=(Cruise_route_planner&& rhs)=delete;
+
+    // turn improving tours with 2-opt on or off, for tours asked for from now on
+    void set_improving(bool enabled) {improving = enabled;}
+    bool get_improving() const {return improving;}
+
+    // the tour starting at the Island with index start in the Edition islands,
+    // which must be the Model's current one
+    Route_ticket get_route(std::shared_ptr<const Island_catalog::Edition> islands, int start);
+
+private:
+    Cruise_route_planner() : improving(false), cached_version(0) { }
+    ~Cruise_route_planner() { }
+
+    bool improving;
+    // the tours of the Edition with cached_version, by start Island and whether improved
+    std::map<std::pair<int, bool>, Route_ticket> cached_routes;
+    int cached_version;
+
+    // each leg to the nearest Island not yet visited, as the Model finds it
+    static std::shared_ptr<const Route> plan_greedy(std::shared_ptr<const Island_catalog::Edition> islands, int start);
+    // shorten a tour by reversing parts of it while that helps; locations are those
+    // of the Edition's Islands, by index
+    static std::vector<int> improve(std::vector<int> stops, std::vector<Point> locations);
+};
+
+#endif
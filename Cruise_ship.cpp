@@ -1,41 +1,85 @@
 #include "Cruise_ship.h"
 #include "Model.h"
 #include "Island.h"
+#include "Snapshot.h"
 #include "Geometry.h"
 #include "Utility.h"
+#include "Event_log.h"
 #include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
 #include <memory>
-#include <set>
 #include <string>
 #include <vector>
 using std::cout;
 using std::endl;
-using std::find_if;
-using std::min_element;
+using std::ostream;
 using std::remove_if;
-using std::set;
 using std::shared_ptr;
+using std::size_t;
 using std::static_pointer_cast;
 using std::string;
 using std::vector;
 
 // Class helper functions
+// mark every Island in the Model as not yet visited
+void Cruise_ship::reset_unvisited_islands() {
+    itinerary_islands = Model::get_instance().get_islands();
+    num_unvisited = static_cast<int>(itinerary_islands->get_islands().size());
+    visited.assign(num_unvisited, false);
+}
+
+// true if island_ptr is not one still to be visited
+bool Cruise_ship::is_visited(const shared_ptr<Island>& island_ptr) const {
+    int index = itinerary_islands->find_index(*island_ptr);
+    return index < 0 || visited[index];
+}
+
+// note that an Island has been visited
+void Cruise_ship::mark_visited(const shared_ptr<Island>& island_ptr) {
+    int index = itinerary_islands->find_index(*island_ptr);
+    if(index >= 0 && !visited[index]) {
+        visited[index] = true;
+        --num_unvisited;
+    }
+}
+
+// the next island of the planned tour, or nullptr if not following it
+/* The tour's next island is the one the Cruise_ship would pick itself only if the
+islands visited are exactly those the tour has reached; since they are marked as
+the tour reaches them, it is enough to compare the counts. */
+shared_ptr<Island> Cruise_ship::next_route_stop() {
+    if(next_stop < 0) {
+        return nullptr;
+    }
+    const Cruise_route_planner::Route& planned_route = *route.get();
+    int num_visited = static_cast<int>(visited.size()) - num_unvisited;
+    if(planned_route.islands != itinerary_islands || num_visited != next_stop ||
+       next_stop >= static_cast<int>(planned_route.stops.size())) {
+        next_stop = -1;
+        return nullptr;
+    }
+    return itinerary_islands->get_islands()[planned_route.stops[next_stop++]];
+}
+
 void Cruise_ship::cancel_cruise() {
     cruise_speed = -1;
     first_destination = cruise_destination = nullptr;
-    islands = Model::get_instance().get_islands();
+    route = Cruise_route_planner::Route_ticket();
+    next_stop = -1;
+    reset_unvisited_islands();
     cruise_state = Cruise_State_e::NOT_CRUISING;
-    cout <<  get_name() << " canceling current cruise" << endl;
+    if(ostream* log = log_event(Event_category_e::CRUISE, Event_level_e::NOTICE))
+        *log << get_name() << " canceling current cruise" << '\n';
 }
 
 // Class Public Interface
 Cruise_ship::Cruise_ship(const string& name_, Point position_) :
     Ship(name_, position_, 500, 15., 2, 0), cruise_speed(0),
-    cruise_state(Cruise_State_e::NOT_CRUISING),
-    islands(Model::get_instance().get_islands()) { }
+    cruise_state(Cruise_State_e::NOT_CRUISING), num_unvisited(0), next_stop(-1) {
+    reset_unvisited_islands();
+}
 
 // Update Cruise_ship state
 void Cruise_ship::update() {
@@ -49,9 +93,10 @@ void Cruise_ship::update() {
             case Cruise_State_e::CRUISING_TO_DESTINATION:
                 if(can_dock(cruise_destination)) {
                     dock(cruise_destination);
-                    if(first_destination == cruise_destination && islands.empty()) {
+                    if(first_destination == cruise_destination && num_unvisited == 0) {
                         cruise_state = Cruise_State_e::NOT_CRUISING;
-                        cout << get_name() << " cruise is over at " << first_destination->get_name() << endl;
+                        if(ostream* log = log_event(Event_category_e::CRUISE, Event_level_e::NOTICE))
+                            *log << get_name() << " cruise is over at " << first_destination->get_name() << '\n';
                     } else {
                         cruise_state = Cruise_State_e::REFUELING;
                     }
@@ -66,36 +111,77 @@ void Cruise_ship::update() {
                 break;
             case Cruise_State_e::LEAVING_ISLAND:
                 // Find the closest, non-visited Island (break ties lexicographically)
-                if(islands.empty()) {
+                if(num_unvisited == 0) {
                     cruise_destination = first_destination;
                 } else {
-                    Point current_location = get_location();
-                    auto closest_island_it =
-                    min_element(islands.begin(), islands.end(),
-                                [&current_location](shared_ptr<Island> island_ptr1, shared_ptr<Island> island_ptr2) {
-                                    double potential_distance1 =
-                                    cartesian_distance(current_location, island_ptr1->get_location());
-                                    double potential_distance2 =
-                                    cartesian_distance(current_location, island_ptr2->get_location());
-                                    if(abs(potential_distance1 - potential_distance2) < .01) {
-                                        return island_ptr1->get_name() < island_ptr2->get_name();
-                                    } else {
-                                        return potential_distance1 < potential_distance2;
-                                    }
-                                });
-                    cruise_destination = *closest_island_it;
-                    islands.erase(closest_island_it);
+                    cruise_destination = next_route_stop();
+                    if(!cruise_destination) {
+                        cruise_destination = Model::get_instance().nearest_island(get_location(),
+                            [this](const shared_ptr<Island>& island_ptr)
+                                { return is_visited(island_ptr); });
+                    }
+                    assert(cruise_destination);
+                    mark_visited(cruise_destination);
                 }
                 Ship::set_destination_position_and_speed(cruise_destination->get_location(), cruise_speed);
-                cout << get_name() << " will visit " << cruise_destination->get_name() << endl;
+                if(ostream* log = log_event(Event_category_e::CRUISE, Event_level_e::NOTICE))
+                    *log << get_name() << " will visit " << cruise_destination->get_name() << '\n';
                 cruise_state = Cruise_State_e::CRUISING_TO_DESTINATION;
                 break;
             default:
-                cout << default_switch_error_c << endl;
+                if(ostream* log = log_event(Event_category_e::CRUISE, Event_level_e::NOTICE))
+                    *log << default_switch_error_c << '\n';
         };
     }
 }
 
+// idle if the Ship is idle and not on a cruise
+bool Cruise_ship::is_idle() const {
+    return Ship::is_idle() && cruise_state == Cruise_State_e::NOT_CRUISING;
+}
+
+// add the cruise and its itinerary to the Ship's state
+void Cruise_ship::save_state(Snapshot_writer& writer) const {
+    Ship::save_state(writer);
+    writer.write_int(cruise_speed);
+    writer.write_byte(static_cast<unsigned char>(cruise_state));
+    writer.write_island_ref(first_destination);
+    writer.write_island_ref(cruise_destination);
+    writer.write_count(num_unvisited);
+    const vector<shared_ptr<Island>>& islands = itinerary_islands->get_islands();
+    for(size_t index = 0; index < islands.size(); ++index) {
+        if(!visited[index]) {
+            writer.write_island_ref(islands[index]);
+        }
+    }
+}
+
+void Cruise_ship::load_state(Snapshot_reader& reader) {
+    Ship::load_state(reader);
+    cruise_speed = reader.read_int();
+    cruise_state = static_cast<Cruise_State_e>(reader.read_choice(static_cast<int>(Cruise_State_e::LEAVING_ISLAND) + 1));
+    first_destination = reader.read_island_ref();
+    cruise_destination = reader.read_island_ref();
+    // the islands written are those still to be visited
+    itinerary_islands = reader.get_island_edition();
+    num_unvisited = 0;
+    visited.assign(itinerary_islands->get_islands().size(), true);
+    for(size_t num_to_read = reader.read_count(); num_to_read > 0; --num_to_read) {
+        shared_ptr<Island> island_ptr = reader.read_island_ref();
+        int index = island_ptr ? itinerary_islands->find_index(*island_ptr) : -1;
+        if(index < 0) {
+            throw Error("Invalid snapshot file!");
+        }
+        if(visited[index]) {
+            visited[index] = false;
+            ++num_unvisited;
+        }
+    }
+    // the tour would be planned for the Islands being replaced
+    route = Cruise_route_planner::Route_ticket();
+    next_stop = -1;
+}
+
 void Cruise_ship::describe() const {
     cout << "\nCruise_ship ";
     Ship::describe();
@@ -123,22 +209,19 @@ void Cruise_ship::set_destination_position_and_speed(Point destination_position,
     }
     Ship::set_destination_position_and_speed(destination_position, speed);
     
-    vector<shared_ptr<Island>> all_islands = Model::get_instance().get_islands();
-    auto possible_island_it = find_if(all_islands.begin(), all_islands.end(),
-                            [&destination_position](shared_ptr<Island> island_ptr)
-                                   { return island_ptr->get_location() == destination_position; });
-    if(possible_island_it != all_islands.end()) {
-        for(auto islands_it = islands.begin(); islands_it != islands.end(); ++islands_it) {
-            if((*islands_it)->get_name() == (*possible_island_it)->get_name()) {
-                islands.erase(islands_it);
-                break;
-            }
-        }
-        first_destination = cruise_destination = *possible_island_it;
+    shared_ptr<Island> possible_island = Model::get_instance().get_islands()->find_at(destination_position);
+    if(possible_island) {
+        mark_visited(possible_island);
+        route = Cruise_route_planner::get_instance().get_route(itinerary_islands,
+                                                                itinerary_islands->find_index(*possible_island));
+        next_stop = 1;
+        first_destination = cruise_destination = possible_island;
         cruise_state = Cruise_State_e::CRUISING_TO_DESTINATION;
         cruise_speed = speed;
-        cout << get_name() << " will visit " << cruise_destination->get_name() << endl;
-        cout << get_name() << " cruise will start and end at " << cruise_destination->get_name() << endl;
+        if(ostream* log = log_event(Event_category_e::CRUISE, Event_level_e::NOTICE))
+            *log << get_name() << " will visit " << cruise_destination->get_name() << '\n';
+        if(ostream* log = log_event(Event_category_e::CRUISE, Event_level_e::NOTICE))
+            *log << get_name() << " cruise will start and end at " << cruise_destination->get_name() << '\n';
     }
 }
 
@@ -157,7 +240,8 @@ void Cruise_ship::stop() {
     Ship::stop();
 }
 
-void Cruise_ship::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr) {
-    Ship::receive_hit(hit_force, attacker_ptr);
+// tell the attacker it has attacked a Cruise_ship
+void Cruise_ship::respond_to_hit(shared_ptr<Ship> attacker_ptr) {
+    Model::get_instance().wake(shared_from_this());
     attacker_ptr->respond_to_attack(static_pointer_cast<Cruise_ship>(shared_from_this()));
 }
\ No newline at end of file
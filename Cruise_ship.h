@@ -11,10 +11,20 @@
  
     A Cruise_ship has fuel capacity and initial amount 500 tons, maximum speed 15., 
     fuel consumption 2 tons/nm, and resistance 0
+
+    The itinerary is kept as a bitset of the islands visited so far, by their place
+    in the Model's shared Edition of the islands (see Island_catalog), rather than as
+    a set of the islands of its own. The tour is planned once for each start island
+    and shared (see Cruise_route_planner); the Cruise_ship follows it while the
+    islands it has visited are the ones the tour has reached, and otherwise, as after
+    being loaded from a snapshot, picks each island as it leaves the last one.
  */
 #include "Ship.h"
-#include <vector>
+#include "Cruise_route_planner.h"
+#include "Island_catalog.h"
+#include <memory>
 #include <string>
+#include <vector>
 
 class Cruise_ship : public Ship {
 public:
@@ -23,6 +33,13 @@ public:
     
     // Update Cruise_ship state
     void update() override;
+    // idle if the Ship is idle and not on a cruise
+    bool is_idle() const override;
+    const char* get_type_name() const override
+        {return "Cruise_ship";}
+    // add the cruise and its itinerary to the Ship's state
+    void save_state(Snapshot_writer& writer) const override;
+    void load_state(Snapshot_reader& reader) override;
     
     // Describe Cruise_ship state
     void describe() const override;
@@ -35,10 +52,12 @@ public:
     // Stop moving
     void stop() override;
     
-    void receive_hit(int hit_force, std::shared_ptr<Ship> attacker_ptr) override;
+    // tell the attacker it has attacked a Cruise_ship
+    void respond_to_hit(std::shared_ptr<Ship> attacker_ptr) override;
     
 private:
     // Enums for current Cruise state
+    // LEAVING_ISLAND must stay last; snapshots check states against it
     enum class Cruise_State_e {
         NOT_CRUISING, CRUISING_TO_DESTINATION, REFUELING,
         DOCKED_SIGHTSEEING, LEAVING_ISLAND
@@ -48,10 +67,24 @@ private:
     Cruise_State_e cruise_state;
     std::shared_ptr<Island> first_destination;
     std::shared_ptr<Island> cruise_destination;
-    std::vector<std::shared_ptr<Island>> islands;
+    // the islands of the itinerary, and which of them have been visited
+    std::shared_ptr<const Island_catalog::Edition> itinerary_islands;
+    std::vector<bool> visited;
+    int num_unvisited;
+    // the planned tour, and the place in it of the next island, or -1 if not following it
+    Cruise_route_planner::Route_ticket route;
+    int next_stop;
 
     // Class helper functions
     void cancel_cruise();
+    // mark every Island in the Model as not yet visited
+    void reset_unvisited_islands();
+    // true if island_ptr is not one still to be visited
+    bool is_visited(const std::shared_ptr<Island>& island_ptr) const;
+    // note that an Island has been visited
+    void mark_visited(const std::shared_ptr<Island>& island_ptr);
+    // the next island of the planned tour, or nullptr if not following it
+    std::shared_ptr<Island> next_route_stop();
 };
 
 
@@ -1,8 +1,12 @@
 #include "Cruiser.h"
+#include "Event_log.h"
+#include "Model.h"
 #include <iostream>
 #include <memory>
 using std::cout;
 using std::endl;
+using std::ostream;
+using std::ostream;
 using std::shared_ptr;
 using std::static_pointer_cast;
 
@@ -16,7 +20,8 @@ void Cruiser::update() {
         if(get_target() && target_in_range()) {
             fire_at_target();
         } else {
-            cout << get_name() << " target is out of range" << endl;
+            if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::NOTICE))
+                *log << get_name() << " target is out of range" << '\n';
             stop_attack();
         }
     }
@@ -27,8 +32,10 @@ void Cruiser::describe() const {
     Warship::describe();
 }
 
-void Cruiser::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr) {
-    Ship::receive_hit(hit_force, attacker_ptr);
+// attack back if afloat and not attacking already, and tell the attacker
+// it has attacked a Cruiser
+void Cruiser::respond_to_hit(shared_ptr<Ship> attacker_ptr) {
+    Model::get_instance().wake(shared_from_this());
     if(is_afloat() && !is_attacking()) { // TODO - put this in response?
         Warship::attack(attacker_ptr);
     }
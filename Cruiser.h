@@ -19,9 +19,13 @@ public:
 	// initialize, then output constructor message
 	Cruiser(const std::string& name_, Point position_);
 
+	const char* get_type_name() const override
+		{return "Cruiser";}
 	void update() override;
 	void describe() const override;
-    void receive_hit(int hit_force, std::shared_ptr<Ship> attacker_ptr) override;
+    // attack back if afloat and not attacking already, and tell the attacker
+    // it has attacked a Cruiser
+    void respond_to_hit(std::shared_ptr<Ship> attacker_ptr) override;
 };
 
 #endif
\ No newline at end of file
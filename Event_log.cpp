@@ -0,0 +1,189 @@
+#include "Event_log.h"
+#include "Utility.h"
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using std::cout;
+using std::lock_guard;
+using std::mutex;
+using std::size_t;
+using std::streamsize;
+using std::string;
+using std::thread;
+using std::unique_lock;
+
+// the size of the block cout's text is gathered in
+const size_t event_block_size_c = 1 << 16;
+// hand_over waits while this much text is waiting for the writer thread
+const size_t max_pending_text_c = 1 << 23;
+const char* const event_category_names_c[num_event_categories_c] =
+    {"movement", "fuel", "cargo", "orders", "combat", "cruise"};
+
+// the Event_log; the first call takes over cout and starts the writer thread
+Event_log& Event_log::get_instance() {
+    static Event_log event_log;
+    return event_log;
+}
+
+// take over cout and start the writer thread
+Event_log::Event_log() : wanted(0), verbosity(static_cast<int>(Event_level_e::DETAIL)),
+    muted{}, suppressed(false), console(cout.rdbuf()), block_streambuf(*this),
+    flush_pending(false), writing(false), stopping(false) {
+    update_wanted();
+    cout.rdbuf(&block_streambuf);
+    writer_thread = thread(&Event_log::writer_loop, this);
+}
+
+// write out what is left, give cout back its streambuf, and stop the thread
+Event_log::~Event_log() {
+    block_streambuf.pubsync();
+    {
+        lock_guard<mutex> lock(pending_mutex);
+        stopping = true;
+    }
+    writer_cv.notify_one();
+    writer_thread.join();
+    if(cout.rdbuf() == &block_streambuf) {
+        cout.rdbuf(console);
+    }
+    console->pubsync();
+}
+
+// 0 for no events, 1 for notices only, 2 for every event
+// will throw Error("Verbosity must be 0, 1, or 2!") if out of range
+void Event_log::set_verbosity(int verbosity_) {
+    if(verbosity_ < 0 || verbosity_ > static_cast<int>(Event_level_e::DETAIL)) {
+        throw Error("Verbosity must be 0, 1, or 2!");
+    }
+    verbosity = verbosity_;
+    update_wanted();
+}
+
+// mute or unmute the events of a category
+void Event_log::set_muted(Event_category_e category, bool muted_) {
+    muted[static_cast<int>(category)] = muted_;
+    update_wanted();
+}
+
+// will throw Error("Unknown event category!") if there is no category of that name
+Event_category_e Event_log::get_category(const string& name) {
+    for(int category = 0; category < num_event_categories_c; ++category) {
+        if(name == event_category_names_c[category]) {
+            return static_cast<Event_category_e>(category);
+        }
+    }
+    throw Error("Unknown event category!");
+}
+
+// hand everything written so far to the writer thread and wait until it has
+// reached the console
+void Event_log::flush() {
+    block_streambuf.pubsync();
+    unique_lock<mutex> lock(pending_mutex);
+    taken_cv.wait(lock, [this] { return pending.empty() && !flush_pending && !writing; });
+}
+
+// work out wanted from the settings
+void Event_log::update_wanted() {
+    wanted = 0;
+    if(suppressed) {
+        return;
+    }
+    for(int category = 0; category < num_event_categories_c; ++category) {
+        if(muted[category]) {
+            continue;
+        }
+        for(int level = static_cast<int>(Event_level_e::NOTICE); level <= verbosity; ++level) {
+            wanted |= event_bit(static_cast<Event_category_e>(category), static_cast<Event_level_e>(level));
+        }
+    }
+}
+
+// add text for the writer thread, waiting if too much is already waiting
+void Event_log::hand_over(const char* text, size_t count, bool flush_console) {
+    {
+        unique_lock<mutex> lock(pending_mutex);
+        taken_cv.wait(lock, [this] { return pending.size() < max_pending_text_c; });
+        pending.append(text, count);
+        flush_pending = flush_pending || flush_console;
+    }
+    writer_cv.notify_one();
+}
+
+// wait for text, write it to the console, repeat until told to stop and none is left
+/* The text is swapped out of pending, so that the two strings' storage is reused
+rather than allocated again for every block. The thread takes no signals, so that
+they go to the threads that expect them (see Command_server). */
+void Event_log::writer_loop() {
+    sigset_t all_signals;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_BLOCK, &all_signals, nullptr);
+    string taken;
+    unique_lock<mutex> lock(pending_mutex);
+    while(true) {
+        writer_cv.wait(lock, [this] { return !pending.empty() || flush_pending || stopping; });
+        if(pending.empty() && !flush_pending) {
+            return;
+        }
+        taken.swap(pending);
+        bool flush_console = flush_pending;
+        flush_pending = false;
+        writing = true;
+        lock.unlock();
+        taken_cv.notify_all();
+        console->sputn(taken.data(), static_cast<streamsize>(taken.size()));
+        taken.clear();
+        if(flush_console) {
+            console->pubsync();
+        }
+        lock.lock();
+        writing = false;
+        taken_cv.notify_all();
+    }
+}
+
+Event_log::Suppression::Suppression(bool suppress) :
+    was_suppressed(Event_log::get_instance().suppressed) {
+    if(suppress) {
+        Event_log& event_log = Event_log::get_instance();
+        event_log.suppressed = true;
+        event_log.update_wanted();
+    }
+}
+
+Event_log::Suppression::~Suppression() {
+    Event_log& event_log = Event_log::get_instance();
+    if(event_log.suppressed != was_suppressed) {
+        event_log.suppressed = was_suppressed;
+        event_log.update_wanted();
+    }
+}
+
+Event_log::Block_streambuf::Block_streambuf(Event_log& log_) : log(log_), block(event_block_size_c) {
+    setp(block.data(), block.data() + block.size());
+}
+
+Event_log::Block_streambuf::int_type Event_log::Block_streambuf::overflow(int_type c) {
+    hand_over(false);
+    if(!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+int Event_log::Block_streambuf::sync() {
+    hand_over(true);
+    return 0;
+}
+
+// hand the block to the writer thread, asking it to flush the console after it if flush_console
+void Event_log::Block_streambuf::hand_over(bool flush_console) {
+    log.hand_over(pbase(), static_cast<size_t>(pptr() - pbase()), flush_console);
+    setp(block.data(), block.data() + block.size());
+}
@@ -0,0 +1,128 @@
+/* Event_log class
+The Event_log decides which of the events reported by the Sim_objects are written
+out, and writes the console's text out in large blocks on a thread of its own.
+
+Each event has a category (movement, fuel, cargo, orders, combat, cruise) and a
+level: DETAIL for the routine reports made on every tick, such as where each Ship
+now is, and NOTICE for everything else. An event is written only if its category
+is not muted, its level is within the verbosity, and events are not suppressed;
+otherwise it is not even formatted. Model::update suppresses them while console
+events are off, since they would be discarded anyway. With the verbosity at
+DETAIL and no category muted, the output is the same as it has always been.
+
+Events are written to cout, so that they stay in order with the rest of the output
+wherever cout goes, and they end their lines with '\n' rather than endl, so that
+they do not flush it. Beneath cout, the Event_log's streambuf fills a large block
+and hands it to the writer thread when it is full or when cout is flushed, as it is
+before cin reads a command; the writer thread then writes it to the console. For
+everything to go out in order, the Event_log must be the first to take over cout,
+before the Render_thread, so it is created first thing in main.
+*/
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class Event_category_e : unsigned char { MOVEMENT, FUEL, CARGO, ORDERS, COMBAT, CRUISE };
+const int num_event_categories_c = 6;
+enum class Event_level_e : unsigned char { NOTICE = 1, DETAIL = 2 };
+
+class Event_log {
+public:
+    // the Event_log; the first call takes over cout and starts the writer thread
+    static Event_log& get_instance();
+
+    // disallow copy/move construction or assignment
+    Event_log(Event_log& other)=delete;
+    Event_log(Event_log&& other)=delete;
+    Event_log& operator=(Event_log& rhs)=delete;
+    Event_log& operator=(Event_log&& rhs)=delete;
+
+    // the stream to write an event of this category and level to, or nullptr if
+    // it is not wanted
+    std::ostream* get_stream(Event_category_e category, Event_level_e level) const
+        {return (wanted & event_bit(category, level)) ? &std::cout : nullptr;}
+
+    // 0 for no events, 1 for notices only, 2 for every event
+    // will throw Error("Verbosity must be 0, 1, or 2!") if out of range
+    void set_verbosity(int verbosity_);
+    int get_verbosity() const
+        {return verbosity;}
+    // mute or unmute the events of a category
+    void set_muted(Event_category_e category, bool muted_);
+    // will throw Error("Unknown event category!") if there is no category of that name
+    static Event_category_e get_category(const std::string& name);
+
+    // Suppresses all events for as long as it exists, if suppress is true
+    class Suppression {
+    public:
+        explicit Suppression(bool suppress);
+        ~Suppression();
+        Suppression(Suppression& other)=delete;
+        Suppression& operator=(Suppression& rhs)=delete;
+    private:
+        bool was_suppressed;
+    };
+
+    // hand everything written so far to the writer thread and wait until it has
+    // reached the console
+    void flush();
+
+private:
+    // what cout writes to while the Event_log exists
+    class Block_streambuf : public std::streambuf {
+    public:
+        explicit Block_streambuf(Event_log& log_);
+    protected:
+        int_type overflow(int_type c) override;
+        int sync() override;
+    private:
+        Event_log& log;
+        std::vector<char> block;
+        // hand the block to the writer thread, asking it to flush the console after it if flush_console
+        void hand_over(bool flush_console);
+    };
+
+    unsigned int wanted;        // a bit for each category and level that is written
+    int verbosity;
+    bool muted[num_event_categories_c];
+    bool suppressed;
+
+    std::streambuf* console;    // cout's streambuf before we took it over
+    Block_streambuf block_streambuf;
+    // text handed over but not yet taken by the writer thread; these four are guarded by pending_mutex
+    std::string pending;
+    bool flush_pending;         // flush the console after writing pending
+    bool writing;               // the writer thread is writing out what it took
+    bool stopping;
+    std::mutex pending_mutex;
+    std::condition_variable writer_cv;      // wakes the writer thread
+    std::condition_variable taken_cv;       // wakes those waiting for text to be taken or written
+    std::thread writer_thread;
+
+    // take over cout and start the writer thread
+    Event_log();
+    // write out what is left, give cout back its streambuf, and stop the thread
+    ~Event_log();
+
+    static unsigned int event_bit(Event_category_e category, Event_level_e level)
+        {return 1u << (static_cast<int>(category) * 2 + static_cast<int>(level) - 1);}
+    // work out wanted from the settings
+    void update_wanted();
+    // add text for the writer thread, waiting if too much is already waiting
+    void hand_over(const char* text, std::size_t count, bool flush_console);
+    // wait for text, write it to the console, repeat until told to stop and none is left
+    void writer_loop();
+};
+
+// the stream to write an event of this category and level to, or nullptr if it is
+// not wanted
+inline std::ostream* log_event(Event_category_e category, Event_level_e level)
+    {return Event_log::get_instance().get_stream(category, level);}
+
+#endif
@@ -0,0 +1,73 @@
+/* Id_map class template
+An Id_map holds at most one value per Sim_object ID (see Name_registry) in a flat
+vector indexed by the ID, so finding, adding, and removing an object's value are all
+constant time with no string comparisons or node allocations. It can be traversed
+either in ID order or in alphabetical order of the objects' names.
+*/
+#ifndef ID_MAP_H
+#define ID_MAP_H
+#include "Name_registry.h"
+#include <vector>
+
+template<typename T>
+class Id_map {
+public:
+    // the value for id, added with a default value if not present
+    T& operator[](int id)
+    {
+        if(id >= static_cast<int>(values.size())) {
+            values.resize(id + 1);
+            present.resize(id + 1, false);
+        }
+        if(!present[id]) {
+            values[id] = T();
+            present[id] = true;
+        }
+        return values[id];
+    }
+    // pointer to the value for id, or nullptr if not present
+    T* find(int id)
+        {return contains(id) ? &values[id] : nullptr;}
+    const T* find(int id) const
+        {return contains(id) ? &values[id] : nullptr;}
+    bool contains(int id) const
+        {return id >= 0 && id < static_cast<int>(present.size()) && present[id];}
+    // remove the value for id; no error if it is not present
+    void erase(int id)
+    {
+        if(contains(id)) {
+            present[id] = false;
+        }
+    }
+    void clear()
+    {
+        values.clear();
+        present.clear();
+    }
+    // call f(id, value) for every value present, in ID order
+    template<typename F>
+    void for_each(F f) const
+    {
+        for(int id = 0; id < static_cast<int>(present.size()); ++id) {
+            if(present[id]) {
+                f(id, values[id]);
+            }
+        }
+    }
+    // call f(id, value) for every value present, in alphabetical order of the names
+    template<typename F>
+    void for_each_in_name_order(F f) const
+    {
+        for(int id : Name_registry::get_instance().get_ids_in_name_order()) {
+            if(contains(id)) {
+                f(id, values[id]);
+            }
+        }
+    }
+
+private:
+    std::vector<T> values;
+    std::vector<bool> present;
+};
+
+#endif
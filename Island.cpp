@@ -1,10 +1,15 @@
 #include "Island.h"
+#include "Event_log.h"
 #include "Model.h"
+#include "Snapshot.h"
+#include "Telemetry.h"
 #include <iostream>
 #include <string>
 using std::string;
 using std::cout;
 using std::endl;
+using std::ostream;
+using std::ostream;
 
 // initialize then output constructor message
 Island::Island(const std::string& name_, Point position_, double fuel_, double production_rate_)
@@ -15,20 +20,31 @@ Island::Island(const std::string& name_, Point position_, double fuel_, double p
 double Island::provide_fuel(double request) {
     double reduction = (request < fuel) ? request : fuel;
     fuel -= reduction;
-    cout << "Island " << get_name() << " supplied " << reduction << " tons of fuel" << endl;
+    if(ostream* log = log_event(Event_category_e::FUEL, Event_level_e::NOTICE))
+        *log << "Island " << get_name() << " supplied " << reduction << " tons of fuel" << '\n';
     return reduction;
 }
 
 // Add the amount to the amount on hand, and output the total as the amount the Island now has.
 void Island::accept_fuel(double amount) {
-    cout << "Island " << get_name() << " now has " << (fuel += amount) << " tons" << endl;
+    fuel += amount;
+    if(ostream* log = log_event(Event_category_e::FUEL, Event_level_e::NOTICE))
+        *log << "Island " << get_name() << " now has " << fuel << " tons" << '\n';
 }
 
 // if production_rate > 0, compute production_rate * unit time, and add to amount, and print an update message
 void Island::update() {
     if(production_rate > 0) {
         fuel += production_rate;
-        cout << "Island " << get_name() << " now has " << fuel << " tons" << endl;
+        if(ostream* log = log_event(Event_category_e::FUEL, Event_level_e::DETAIL))
+            *log << "Island " << get_name() << " now has " << fuel << " tons" << '\n';
+    }
+}
+
+// add the production of num_ticks updates
+void Island::skip_ticks(int num_ticks) {
+    if(production_rate > 0) {
+        fuel += production_rate * num_ticks;
     }
 }
 
@@ -40,5 +56,28 @@ void Island::describe() const{
 
 // ask model to notify views of current state
 void Island::broadcast_current_state() {
-    Model::get_instance().notify_location(get_name(), position);
-}
\ No newline at end of file
+    Model::get_instance().notify_location(get_id(), position);
+}
+
+// write the Island's position, fuel, and production rate
+void Island::save_state(Snapshot_writer& writer) const {
+    writer.write_double(position.x);
+    writer.write_double(position.y);
+    writer.write_double(fuel);
+    writer.write_double(production_rate);
+}
+
+// replace them with what save_state wrote
+void Island::load_state(Snapshot_reader& reader) {
+    position.x = reader.read_double();
+    position.y = reader.read_double();
+    fuel = reader.read_double();
+    production_rate = reader.read_double();
+}
+
+// fill in the Island's position and fuel as the telemetry records them
+void Island::report_telemetry(Telemetry_record& record) const {
+    record.fields = Telemetry_record::LOCATION | Telemetry_record::FUEL;
+    record.location = position;
+    record.fuel = fuel;
+}
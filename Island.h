@@ -7,8 +7,13 @@ accordingly.
 #define ISLAND_H
 #include "Sim_object.h"
 #include "Geometry.h"
+#include <climits>
 #include <string>
 
+class Snapshot_writer;
+class Snapshot_reader;
+struct Telemetry_record;
+
 class Island : public Sim_object {
 public:
 	// initialize then output constructor message
@@ -30,6 +35,13 @@ public:
 
 	// if production_rate > 0, compute production_rate * unit time, and add to amount, and print an update message
 	void update() override;
+	// idle if there is no production
+	bool is_idle() const override
+		{return production_rate <= 0;}
+	// production can always be skipped ahead
+	int ticks_until_event() const override
+		{return INT_MAX;}
+	void skip_ticks(int num_ticks) override;
 
 	// output information about the current state
 	void describe() const override;
@@ -37,6 +49,13 @@ public:
 	// ask model to notify views of current state
 	void broadcast_current_state() override;
 
+	// write the Island's position, fuel, and production rate
+	void save_state(Snapshot_writer& writer) const;
+	// replace them with what save_state wrote
+	void load_state(Snapshot_reader& reader);
+	// fill in the Island's position and fuel as the telemetry records them
+	void report_telemetry(Telemetry_record& record) const;
+
 private:
     std::string name;
 	Point position;				// Location of this island
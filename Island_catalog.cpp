@@ -0,0 +1,158 @@
+#include "Island_catalog.h"
+#include "Island.h"
+#include "Sim_object.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+using std::function;
+using std::make_shared;
+using std::memcpy;
+using std::abs;
+using std::min_element;
+using std::move;
+using std::shared_ptr;
+using std::size_t;
+using std::sort;
+using std::static_pointer_cast;
+using std::vector;
+
+// distances closer than this count as a tie for nearest; Cruise_ships first compared
+// the difference in distances with .01 after it had been truncated to an int, so this
+// is in effect how close they have always been
+const double nearest_island_tie_c = 1.;
+
+// the first Island in name order at exactly location, or nullptr if none is
+shared_ptr<Island> Island_catalog::Edition::find_at(Point location) const {
+    auto index_it = by_location.find(location);
+    return index_it == by_location.end() ? nullptr : islands[index_it->second];
+}
+
+// the index of an Island in get_islands(), or -1 if it is not in this Edition
+int Island_catalog::Edition::find_index(const Island& island) const {
+    const int* index = indexes.find(island.get_id());
+    return index ? *index : -1;
+}
+
+// Points that compare equal hash the same; -0. is made 0. first
+size_t Island_catalog::Edition::Point_hash::operator() (Point location) const {
+    double coordinates[2] = {location.x + 0., location.y + 0.};
+    unsigned long long bits[2];
+    memcpy(bits, coordinates, sizeof(bits));
+    return std::hash<unsigned long long>()(bits[0] * 31 + bits[1]);
+}
+
+// cell_size_ is the width of a cell of the nearest-Island grid, in nm
+Island_catalog::Island_catalog(double cell_size_) : island_index(cell_size_), last_version(0) { }
+
+// add an Island
+void Island_catalog::insert(shared_ptr<Island> island_ptr) {
+    islands.push_back(island_ptr);
+    island_index.insert(island_ptr, island_ptr->get_location());
+    edition.reset();
+}
+
+// remove every Island
+void Island_catalog::clear() {
+    islands.clear();
+    island_index.clear();
+    edition.reset();
+}
+
+// the current Edition
+shared_ptr<const Island_catalog::Edition> Island_catalog::get_edition() const {
+    if(edition) {
+        return edition;
+    }
+    edition = make_edition(islands);
+    return edition;
+}
+
+// a new Edition of some Islands, such as those of a snapshot still being loaded
+shared_ptr<const Island_catalog::Edition> Island_catalog::make_edition(vector<shared_ptr<Island>> islands_) const {
+    shared_ptr<Edition> new_edition = make_shared<Edition>();
+    new_edition->version = ++last_version;
+    new_edition->islands = move(islands_);
+    sort(new_edition->islands.begin(), new_edition->islands.end(),
+         [](const shared_ptr<Island>& i1, const shared_ptr<Island>& i2)
+            { return i1->get_name() < i2->get_name(); });
+    for(int index = 0; index < static_cast<int>(new_edition->islands.size()); ++index) {
+        const Island& island = *new_edition->islands[index];
+        // emplace keeps the first Island at a location
+        new_edition->by_location.emplace(island.get_location(), index);
+        new_edition->indexes[island.get_id()] = index;
+    }
+    return new_edition;
+}
+
+// make an Edition from make_edition the current one; it must hold exactly the
+// Islands now in the catalog
+void Island_catalog::use_edition(shared_ptr<const Edition> edition_) {
+    edition = edition_;
+}
+
+// return the Island nearest to location, skipping those for which exclude returns true,
+// as Cruise_ships have always chosen it: the first Island in name order, unless a later
+// one is at least 1 nm closer than the one chosen so far. nullptr if every Island is excluded.
+/* This fold over the Islands in name order is not the same as taking the nearest and
+breaking ties by name, and it is kept so that destinations stay the same. It can only move
+to a closer Island, so once the candidates are all the Islands up to some distance d
+with none in (d, d + nearest_island_tie_c], no farther Island can change its result:
+each is too far to be taken over any candidate, and every candidate is far enough
+ahead of it to be taken over it. The grid search is widened until its result holds
+such a gap, and the fold is run over the Islands before the gap. */
+shared_ptr<Island> Island_catalog::nearest(Point location,
+                            const function<bool(const shared_ptr<Island>&)>& exclude) const {
+    struct Candidate {
+        shared_ptr<Island> island_ptr;
+        double distance;
+    };
+    vector<shared_ptr<Sim_object>> found;
+    vector<Candidate> candidates;
+    size_t num_before_gap = 0;
+    // the first search is usually wide enough to find a gap
+    for(double slack = 4 * nearest_island_tie_c; num_before_gap == 0; slack *= 2) {
+        found.clear();
+        island_index.find_nearest(location, slack,
+                                  [&exclude](const shared_ptr<Sim_object>& object_ptr)
+                                    { return !exclude(static_pointer_cast<Island>(object_ptr)); },
+                                  found);
+        if(found.empty()) {
+            return nullptr;
+        }
+        candidates.clear();
+        for(const auto& object_ptr : found) {
+            candidates.push_back(Candidate{static_pointer_cast<Island>(object_ptr),
+                                           cartesian_distance(location, object_ptr->get_location())});
+        }
+        sort(candidates.begin(), candidates.end(),
+             [](const Candidate& c1, const Candidate& c2) { return c1.distance < c2.distance; });
+        for(size_t i = 1; i < candidates.size() && num_before_gap == 0; ++i) {
+            if(candidates[i].distance - candidates[i - 1].distance >= nearest_island_tie_c) {
+                num_before_gap = i;
+            }
+        }
+        // the Islands that were not found are all beyond the search's reach
+        if(num_before_gap == 0 &&
+           candidates.back().distance + 2 * nearest_island_tie_c <= candidates.front().distance + slack) {
+            num_before_gap = candidates.size();
+        }
+    }
+    candidates.resize(num_before_gap);
+    sort(candidates.begin(), candidates.end(),
+         [](const Candidate& c1, const Candidate& c2)
+            { return c1.island_ptr->get_name() < c2.island_ptr->get_name(); });
+    auto chosen_it = min_element(candidates.begin(), candidates.end(),
+                                 [](const Candidate& c1, const Candidate& c2) {
+                                     if(abs(c1.distance - c2.distance) < nearest_island_tie_c) {
+                                         return c1.island_ptr->get_name() < c2.island_ptr->get_name();
+                                     } else {
+                                         return c1.distance < c2.distance;
+                                     }
+                                 });
+    return chosen_it->island_ptr;
+}
@@ -0,0 +1,96 @@
+/* Island_catalog class
+An Island_catalog keeps the Islands for anyone who needs all of them, or needs to
+find one by where it is rather than by name.
+
+The list of all the Islands is handed out as an Edition: an unchanging copy of the
+list, in name order, that is shared by everyone who asks until an Island is added
+or removed. A new Edition, with the next version number, is made the first time it
+is asked for after such a change; holders of the old one keep it for as long as
+they like. So asking for the Islands is only a shared_ptr copy, however many
+Cruise_ships do it.
+
+Each Edition can also find the Island at an exact location, through a hash table,
+and tell where in its list an Island is, so that something kept for each Island,
+such as whether a Cruise_ship has visited it, can be kept in an array or a bitset.
+Finding the nearest Island goes through a Spatial_grid of the Islands, kept up to
+date as they are added and removed.
+
+The catalog is not thread-safe; only the thread running the simulation may use it.
+*/
+#ifndef ISLAND_CATALOG_H
+#define ISLAND_CATALOG_H
+#include "Geometry.h"
+#include "Id_map.h"
+#include "Spatial_grid.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Island;
+
+class Island_catalog {
+public:
+    class Edition {
+    public:
+        // the Edition's version number; each Edition has a greater one than the last
+        int get_version() const
+            {return version;}
+        // the Islands in name order
+        const std::vector<std::shared_ptr<Island>>& get_islands() const
+            {return islands;}
+        // the first Island in name order at exactly location, or nullptr if none is
+        std::shared_ptr<Island> find_at(Point location) const;
+        // the index of an Island in get_islands(), or -1 if it is not in this Edition
+        int find_index(const Island& island) const;
+
+    private:
+        friend class Island_catalog;
+        // Points that compare equal hash the same; -0. is made 0. first
+        struct Point_hash {
+            std::size_t operator() (Point location) const;
+        };
+
+        int version;
+        std::vector<std::shared_ptr<Island>> islands;
+        std::unordered_map<Point, int, Point_hash> by_location;     // index into islands
+        Id_map<int> indexes;        // index into islands, by Island ID
+    };
+
+    // cell_size_ is the width of a cell of the nearest-Island grid, in nm
+    explicit Island_catalog(double cell_size_);
+
+    // disallow copy/move construction or assignment
+    Island_catalog(Island_catalog& other)=delete;
+    Island_catalog(Island_catalog&& other)=delete;
+    Island_catalog& operator=(Island_catalog& rhs)=delete;
+    Island_catalog& operator=(Island_catalog&& rhs)=delete;
+
+    // add an Island
+    void insert(std::shared_ptr<Island> island_ptr);
+    // remove every Island
+    void clear();
+
+    // the current Edition
+    std::shared_ptr<const Edition> get_edition() const;
+    // a new Edition of some Islands, such as those of a snapshot still being loaded
+    std::shared_ptr<const Edition> make_edition(std::vector<std::shared_ptr<Island>> islands_) const;
+    // make an Edition from make_edition the current one; it must hold exactly the
+    // Islands now in the catalog
+    void use_edition(std::shared_ptr<const Edition> edition_);
+    // return the Island nearest to location, skipping those for which exclude returns true,
+    // as Cruise_ships have always chosen it: the first Island in name order, unless a later
+    // one is at least 1 nm closer than the one chosen so far. nullptr if every Island is excluded.
+    std::shared_ptr<Island> nearest(Point location,
+                        const std::function<bool(const std::shared_ptr<Island>&)>& exclude) const;
+
+private:
+    std::vector<std::shared_ptr<Island>> islands;   // in no particular order
+    Spatial_grid island_index;
+    // nullptr if the Islands have changed since it was made
+    mutable std::shared_ptr<const Edition> edition;
+    mutable int last_version;
+};
+
+#endif
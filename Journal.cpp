@@ -0,0 +1,161 @@
+#include "Journal.h"
+#include "Model.h"
+#include "Cruise_route_planner.h"
+#include "Utility.h"
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+using std::ifstream;
+using std::ios;
+using std::size_t;
+using std::istreambuf_iterator;
+using std::string;
+using std::to_string;
+using std::vector;
+
+const char journal_magic_c[8] = {'S', 'H', 'I', 'P', 'J', 'R', 'N', 'L'};
+const int journal_version_c = 3;
+const char* const journal_invalid_error_c = "Invalid journal file!";
+
+// ***** Journal Implementation ***** //
+
+// Create the journal file and save the first checkpoint
+Journal::Journal(const string& filename_, int checkpoint_interval_) :
+    filename(filename_), file(filename_, ios::out | ios::binary | ios::trunc),
+    checkpoint_interval(checkpoint_interval_), next_checkpoint_time(0) {
+    if(!file) {
+        throw Error("Could not open file!");
+    }
+    file.write(journal_magic_c, sizeof(journal_magic_c));
+    file.write(reinterpret_cast<const char*>(&journal_version_c), sizeof(journal_version_c));
+    save_checkpoint();
+}
+
+// Append a command applied at time, then save a checkpoint if one is due
+void Journal::record_command(int time, const string& command) {
+    write_entry(Journal_entry{Journal_entry::Kind_e::COMMAND, time, command, false, false, false, false});
+    if(Model::get_instance().get_time() >= next_checkpoint_time) {
+        save_checkpoint();
+    }
+}
+
+// save a snapshot of the simulation and record a checkpoint entry for it
+void Journal::save_checkpoint() {
+    Model& model = Model::get_instance();
+    int time = model.get_time();
+    string snapshot_filename = filename + "." + to_string(time) + ".snap";
+    model.save(snapshot_filename);
+    write_entry(Journal_entry{Journal_entry::Kind_e::CHECKPOINT, time, snapshot_filename,
+        model.get_console_events(), model.get_time_skipping(),
+        Cruise_route_planner::get_instance().get_improving(), model.get_batched_combat()});
+    next_checkpoint_time = time + checkpoint_interval;
+}
+
+/* An entry is its kind byte, the time, the text length and text, and for a
+checkpoint the four settings bytes. */
+void Journal::write_entry(const Journal_entry& entry) {
+    unsigned char kind = static_cast<unsigned char>(entry.kind);
+    unsigned int length = static_cast<unsigned int>(entry.text.size());
+    file.write(reinterpret_cast<const char*>(&kind), sizeof(kind));
+    file.write(reinterpret_cast<const char*>(&entry.time), sizeof(entry.time));
+    file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    file.write(entry.text.data(), length);
+    if(entry.kind == Journal_entry::Kind_e::CHECKPOINT) {
+        file.put(entry.console_events ? 1 : 0);
+        file.put(entry.time_skipping ? 1 : 0);
+        file.put(entry.tour_improving ? 1 : 0);
+        file.put(entry.batched_combat ? 1 : 0);
+    }
+    file.flush();
+    if(file.fail()) {
+        throw Error("Could not write file!");
+    }
+}
+
+// ***** Journal reading ***** //
+
+// Read every entry of a journal file, in the order written
+vector<Journal_entry> read_journal(const string& filename) {
+    ifstream file(filename, ios::in | ios::binary);
+    if(!file) {
+        throw Error("Could not open file!");
+    }
+    string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    size_t offset = 0;
+    auto read_raw = [&contents, &offset](void* destination, size_t num_bytes) {
+        if(num_bytes > contents.size() - offset) {
+            throw Error(journal_invalid_error_c);
+        }
+        contents.copy(static_cast<char*>(destination), num_bytes, offset);
+        offset += num_bytes;
+    };
+    char magic[sizeof(journal_magic_c)];
+    int version;
+    read_raw(magic, sizeof(magic));
+    read_raw(&version, sizeof(version));
+    if(string(magic, sizeof(magic)) != string(journal_magic_c, sizeof(journal_magic_c))
+       || version != journal_version_c) {
+        throw Error(journal_invalid_error_c);
+    }
+    vector<Journal_entry> entries;
+    while(offset < contents.size()) {
+        Journal_entry entry;
+        unsigned char kind;
+        unsigned int length;
+        read_raw(&kind, sizeof(kind));
+        if(kind >= static_cast<unsigned char>(Journal_entry::Kind_e::NUM_KINDS)) {
+            throw Error(journal_invalid_error_c);
+        }
+        entry.kind = static_cast<Journal_entry::Kind_e>(kind);
+        read_raw(&entry.time, sizeof(entry.time));
+        read_raw(&length, sizeof(length));
+        entry.text.resize(length);
+        read_raw(&entry.text[0], length);
+        entry.console_events = entry.time_skipping = entry.tour_improving = entry.batched_combat = false;
+        if(entry.kind == Journal_entry::Kind_e::CHECKPOINT) {
+            unsigned char settings[4];
+            read_raw(settings, sizeof(settings));
+            entry.console_events = settings[0] != 0;
+            entry.time_skipping = settings[1] != 0;
+            entry.tour_improving = settings[2] != 0;
+            entry.batched_combat = settings[3] != 0;
+        }
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+// ***** Recording_streambuf Implementation ***** //
+
+// return the characters read since the last call, and start again
+/* Only the character handed out last can still be unread by the stream (it may
+have just been peeked), so it is held back for the next command's text. */
+string Recording_streambuf::take_recorded() {
+    size_t unread = (gptr() < egptr()) ? egptr() - gptr() : 0;
+    string taken = recorded.substr(0, recorded.size() - unread);
+    recorded.erase(0, recorded.size() - unread);
+    return taken;
+}
+
+// hand back a character the stream has not read yet, and return the source
+std::streambuf* Recording_streambuf::release_source() {
+    if(gptr() < egptr()) {
+        source->sputbackc(current);
+        setg(&current, &current, &current);
+    }
+    return source;
+}
+
+// fetch the next character from the source and keep a copy of it
+Recording_streambuf::int_type Recording_streambuf::underflow() {
+    int_type next_char = source->sbumpc();
+    if(traits_type::eq_int_type(next_char, traits_type::eof())) {
+        return traits_type::eof();
+    }
+    current = traits_type::to_char_type(next_char);
+    recorded += current;
+    setg(&current, &current, &current + 1);
+    return next_char;
+}
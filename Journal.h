@@ -0,0 +1,95 @@
+/* Journal classes
+A journal is a binary file recording every command the Controller accepted, each
+with the time at which it was applied, so that a session can be run again exactly
+with the "replay" command instead of by feeding a transcript back in.
+
+Because a long session takes long to run again, the Journal also saves a snapshot of
+the whole simulation (see Snapshot.h) when it starts and then every
+checkpoint_interval ticks, next to the journal file, and records a checkpoint entry
+naming it. A replay to a given time starts from the latest checkpoint at or before
+that time and runs only the commands that follow it. A checkpoint entry also keeps
+the settings that decide how updates are computed - console events, time
+skipping, improving cruise tours, and batched combat - since those are not part
+of a snapshot.
+
+Entries are flushed as they are written, so a journal is usable up to its last
+command even if the program does not finish normally.
+*/
+#ifndef JOURNAL_H
+#define JOURNAL_H
+#include <fstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// An entry in a journal file, as read back by read_journal
+struct Journal_entry {
+    enum class Kind_e : unsigned char { COMMAND, CHECKPOINT, NUM_KINDS };
+    // NUM_KINDS must stay last; the reader checks kinds against it
+
+    Kind_e kind;
+    int time;
+    // COMMAND: the command text; CHECKPOINT: the snapshot file name
+    std::string text;
+    // settings in effect at a CHECKPOINT
+    bool console_events;
+    bool time_skipping;
+    bool tour_improving;
+    bool batched_combat;
+};
+
+class Journal {
+public:
+    // Create the journal file and save the first checkpoint
+    // will throw Error("Could not open file!") if the file cannot be created,
+    // or any Error from Model::save
+    Journal(const std::string& filename_, int checkpoint_interval_);
+
+    // disallow copy/move construction or assignment
+    Journal(Journal& other)=delete;
+    Journal(Journal&& other)=delete;
+    Journal& operator=(Journal& rhs)=delete;
+    Journal& operator=(Journal&& rhs)=delete;
+
+    // Append a command applied at time, then save a checkpoint if one is due
+    // will throw Error("Could not write file!") if the journal cannot be written
+    void record_command(int time, const std::string& command);
+
+private:
+    std::string filename;
+    std::ofstream file;
+    int checkpoint_interval;
+    int next_checkpoint_time;
+
+    // save a snapshot of the simulation and record a checkpoint entry for it
+    void save_checkpoint();
+    void write_entry(const Journal_entry& entry);
+};
+
+// Read every entry of a journal file, in the order written
+// will throw Error("Could not open file!") if the file cannot be read
+// will throw Error("Invalid journal file!") if it is not a journal
+std::vector<Journal_entry> read_journal(const std::string& filename);
+
+/* A Recording_streambuf passes the characters of another streambuf through one at
+a time, keeping a copy of each; installed in cin it captures the text of each
+command as the Controller reads it. */
+class Recording_streambuf : public std::streambuf {
+public:
+    explicit Recording_streambuf(std::streambuf* source_) : source(source_) {}
+
+    // return the characters read since the last call, and start again
+    std::string take_recorded();
+    // hand back a character the stream has not read yet, and return the source
+    std::streambuf* release_source();
+
+protected:
+    int_type underflow() override;
+
+private:
+    std::streambuf* source;
+    char current;
+    std::string recorded;
+};
+
+#endif
@@ -0,0 +1,375 @@
+#include "Kinematics_store.h"
+#include "Geometry.h"
+#include "Navigation.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define KINEMATICS_HAVE_AVX2_KERNEL
+#endif
+using std::floor;
+using std::min;
+using std::sqrt;
+using std::vector;
+
+/* The kernels must round exactly like the Geometry and Navigation functions used by
+the one-Ship-at-a-time calculation, so the compiler may not fuse multiplies and adds. */
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+// Raw views of the store's arrays handed to the kernels
+struct Movement_arrays {
+    const double* x;
+    const double* y;
+    const double* speed;
+    const double* dir_x;
+    const double* dir_y;
+    const double* fuel;
+    const double* fuel_consumption;
+    const double* dest_x;
+    const double* dest_y;
+    const Kinematics_store::Motion_e* motion;
+    double* next_x;
+    double* next_y;
+    double* next_fuel;
+    Kinematics_store::Outcome_e* outcome;
+};
+
+// File static functions
+/* One tick of movement for slot s, following Ship::calculate_movement step for step.
+Track_base::update_position moves by Course_speed * time, i.e. by speed * time along
+the course; the unit vector for the course is kept in dir_x, dir_y, so the product
+below is the same one Navigation computes. */
+static void compute_slot(const Movement_arrays& a, int s) {
+    using Motion_e = Kinematics_store::Motion_e;
+    using Outcome_e = Kinematics_store::Outcome_e;
+    if(a.motion[s] == Motion_e::STILL) {
+        a.outcome[s] = Outcome_e::NONE;
+        return;
+    }
+    double time = 1.0;  // "full step" time
+    // get the distance to destination
+    double xd = a.dest_x[s] - a.x[s];
+    double yd = a.dest_y[s] - a.y[s];
+    double destination_distance = sqrt(xd * xd + yd * yd);
+    // get full step distance we can move on this time step
+    double full_distance = a.speed[s] * time;
+    // get fuel required for full step distance
+    double full_fuel_required = full_distance * a.fuel_consumption[s];
+    // how far and how long can we sail in this time period based on the fuel state?
+    double distance_possible, time_possible;
+    if(full_fuel_required <= a.fuel[s]) {
+        distance_possible = full_distance;
+        time_possible = time;
+    } else {
+        distance_possible = a.fuel[s] / a.fuel_consumption[s];
+        time_possible = (distance_possible / full_distance) * time;
+    }
+    // are we are moving to a destination, and is the destination within the distance possible?
+    if(a.motion[s] == Motion_e::TO_POSITION && destination_distance <= distance_possible) {
+        a.next_x[s] = a.dest_x[s];
+        a.next_y[s] = a.dest_y[s];
+        a.next_fuel[s] = a.fuel[s] - destination_distance * a.fuel_consumption[s];
+        a.outcome[s] = Outcome_e::ARRIVED;
+    } else {
+        double distance = a.speed[s] * time_possible;
+        a.next_x[s] = a.x[s] + distance * a.dir_x[s];
+        a.next_y[s] = a.y[s] + distance * a.dir_y[s];
+        if(full_fuel_required >= a.fuel[s]) {
+            a.next_fuel[s] = 0.0;
+            a.outcome[s] = Outcome_e::OUT_OF_FUEL;
+        } else {
+            a.next_fuel[s] = a.fuel[s] - full_fuel_required;
+            a.outcome[s] = Outcome_e::MOVED;
+        }
+    }
+}
+
+static void compute_movement_scalar(const Movement_arrays& a, int begin, int end) {
+    for(int s = begin; s < end; ++s) {
+        compute_slot(a, s);
+    }
+}
+
+#ifdef KINEMATICS_HAVE_AVX2_KERNEL
+/* Four slots per step; every lane computes both branches of compute_slot and the
+masks pick the one compute_slot would have taken. Lanes of still objects compute
+garbage that is never stored. The remaining slots go through compute_slot. */
+__attribute__((target("avx2")))
+static void compute_movement_avx2(const Movement_arrays& a, int begin, int end) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256i still = _mm256_set1_epi64x(static_cast<long long>(Kinematics_store::Motion_e::STILL));
+    const __m256i to_position = _mm256_set1_epi64x(static_cast<long long>(Kinematics_store::Motion_e::TO_POSITION));
+    int s = begin;
+    for(; s + 4 <= end; s += 4) {
+        int motion_bytes;
+        static_assert(sizeof(Kinematics_store::Motion_e) == 1, "Motion_e must be one byte");
+        __builtin_memcpy(&motion_bytes, a.motion + s, sizeof(motion_bytes));
+        __m256i lane_motion = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(motion_bytes));
+        __m256d is_still = _mm256_castsi256_pd(_mm256_cmpeq_epi64(lane_motion, still));
+        __m256d is_to_position = _mm256_castsi256_pd(_mm256_cmpeq_epi64(lane_motion, to_position));
+
+        __m256d x = _mm256_loadu_pd(a.x + s);
+        __m256d y = _mm256_loadu_pd(a.y + s);
+        __m256d speed = _mm256_loadu_pd(a.speed + s);
+        __m256d fuel = _mm256_loadu_pd(a.fuel + s);
+        __m256d fuel_consumption = _mm256_loadu_pd(a.fuel_consumption + s);
+        __m256d dest_x = _mm256_loadu_pd(a.dest_x + s);
+        __m256d dest_y = _mm256_loadu_pd(a.dest_y + s);
+
+        __m256d xd = _mm256_sub_pd(dest_x, x);
+        __m256d yd = _mm256_sub_pd(dest_y, y);
+        __m256d destination_distance = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(xd, xd), _mm256_mul_pd(yd, yd)));
+        __m256d full_distance = _mm256_mul_pd(speed, one);
+        __m256d full_fuel_required = _mm256_mul_pd(full_distance, fuel_consumption);
+        __m256d enough_fuel = _mm256_cmp_pd(full_fuel_required, fuel, _CMP_LE_OQ);
+        __m256d fuel_distance = _mm256_div_pd(fuel, fuel_consumption);
+        __m256d distance_possible = _mm256_blendv_pd(fuel_distance, full_distance, enough_fuel);
+        __m256d time_possible = _mm256_blendv_pd(_mm256_mul_pd(_mm256_div_pd(fuel_distance, full_distance), one),
+                                                 one, enough_fuel);
+        __m256d arrives = _mm256_and_pd(is_to_position,
+                                        _mm256_cmp_pd(destination_distance, distance_possible, _CMP_LE_OQ));
+        __m256d out_of_fuel = _mm256_cmp_pd(full_fuel_required, fuel, _CMP_GE_OQ);
+
+        __m256d distance = _mm256_mul_pd(speed, time_possible);
+        __m256d moved_x = _mm256_add_pd(x, _mm256_mul_pd(distance, _mm256_loadu_pd(a.dir_x + s)));
+        __m256d moved_y = _mm256_add_pd(y, _mm256_mul_pd(distance, _mm256_loadu_pd(a.dir_y + s)));
+        __m256d moved_fuel = _mm256_blendv_pd(_mm256_sub_pd(fuel, full_fuel_required), zero, out_of_fuel);
+        __m256d arrived_fuel = _mm256_sub_pd(fuel, _mm256_mul_pd(destination_distance, fuel_consumption));
+
+        _mm256_storeu_pd(a.next_x + s, _mm256_blendv_pd(moved_x, dest_x, arrives));
+        _mm256_storeu_pd(a.next_y + s, _mm256_blendv_pd(moved_y, dest_y, arrives));
+        _mm256_storeu_pd(a.next_fuel + s, _mm256_blendv_pd(moved_fuel, arrived_fuel, arrives));
+
+        int still_bits = _mm256_movemask_pd(is_still);
+        int arrived_bits = _mm256_movemask_pd(arrives);
+        int out_of_fuel_bits = _mm256_movemask_pd(out_of_fuel);
+        for(int lane = 0; lane < 4; ++lane) {
+            int bit = 1 << lane;
+            Kinematics_store::Outcome_e lane_outcome;
+            if(still_bits & bit) {
+                lane_outcome = Kinematics_store::Outcome_e::NONE;
+            } else if(arrived_bits & bit) {
+                lane_outcome = Kinematics_store::Outcome_e::ARRIVED;
+            } else if(out_of_fuel_bits & bit) {
+                lane_outcome = Kinematics_store::Outcome_e::OUT_OF_FUEL;
+            } else {
+                lane_outcome = Kinematics_store::Outcome_e::MOVED;
+            }
+            a.outcome[s + lane] = lane_outcome;
+        }
+    }
+    compute_movement_scalar(a, s, end);
+}
+#endif
+
+// static method to get the instance of Kinematics_store
+Kinematics_store& Kinematics_store::get_instance() {
+    static Kinematics_store store;
+    return store;
+}
+
+Kinematics_store::Kinematics_store() { }
+
+// add a still object at position with the given fuel state; return its handle
+int Kinematics_store::add(Point position, double fuel_, double fuel_consumption_) {
+    int handle;
+    if(free_handles.empty()) {
+        handle = static_cast<int>(slot_of_handle.size());
+        slot_of_handle.push_back(0);
+    } else {
+        handle = free_handles.back();
+        free_handles.pop_back();
+    }
+    slot_of_handle[handle] = size();
+    handle_of_slot.push_back(handle);
+    x.push_back(position.x);
+    y.push_back(position.y);
+    course.push_back(0.);
+    speed.push_back(0.);
+    dir_x.push_back(0.);
+    dir_y.push_back(0.);
+    fuel.push_back(fuel_);
+    fuel_consumption.push_back(fuel_consumption_);
+    dest_x.push_back(0.);
+    dest_y.push_back(0.);
+    motion.push_back(Motion_e::STILL);
+    next_x.push_back(0.);
+    next_y.push_back(0.);
+    next_fuel.push_back(0.);
+    outcome.push_back(Outcome_e::NONE);
+    set_course(handle, 0.);
+    return handle;
+}
+
+// discard the handle and its slot; the last slot moves into the hole
+void Kinematics_store::remove(int handle) {
+    int slot = slot_of_handle[handle];
+    int last = size() - 1;
+    if(slot != last) {
+        x[slot] = x[last];
+        y[slot] = y[last];
+        course[slot] = course[last];
+        speed[slot] = speed[last];
+        dir_x[slot] = dir_x[last];
+        dir_y[slot] = dir_y[last];
+        fuel[slot] = fuel[last];
+        fuel_consumption[slot] = fuel_consumption[last];
+        dest_x[slot] = dest_x[last];
+        dest_y[slot] = dest_y[last];
+        motion[slot] = motion[last];
+        next_x[slot] = next_x[last];
+        next_y[slot] = next_y[last];
+        next_fuel[slot] = next_fuel[last];
+        outcome[slot] = outcome[last];
+        handle_of_slot[slot] = handle_of_slot[last];
+        slot_of_handle[handle_of_slot[slot]] = slot;
+    }
+    x.pop_back();
+    y.pop_back();
+    course.pop_back();
+    speed.pop_back();
+    dir_x.pop_back();
+    dir_y.pop_back();
+    fuel.pop_back();
+    fuel_consumption.pop_back();
+    dest_x.pop_back();
+    dest_y.pop_back();
+    motion.pop_back();
+    next_x.pop_back();
+    next_y.pop_back();
+    next_fuel.pop_back();
+    outcome.pop_back();
+    handle_of_slot.pop_back();
+    free_handles.push_back(handle);
+}
+
+// make room for num_objects more objects
+void Kinematics_store::reserve(int num_objects) {
+    auto capacity = motion.size() + num_objects;
+    for(vector<double>* array : {&x, &y, &course, &speed, &dir_x, &dir_y, &fuel, &fuel_consumption,
+                                 &dest_x, &dest_y, &next_x, &next_y, &next_fuel}) {
+        array->reserve(capacity);
+    }
+    motion.reserve(capacity);
+    outcome.reserve(capacity);
+    slot_of_handle.reserve(capacity);
+    handle_of_slot.reserve(capacity);
+}
+
+void Kinematics_store::set_position(int handle, Point position) {
+    int s = slot_of_handle[handle];
+    x[s] = position.x;
+    y[s] = position.y;
+    outcome[s] = Outcome_e::NONE;
+}
+
+// the unit displacement is what Navigation adds to a Point for one nm along course_
+void Kinematics_store::set_course(int handle, double course_) {
+    int s = slot_of_handle[handle];
+    Point unit_step = Point(0., 0.) + Compass_vector(course_, 1.);
+    course[s] = course_;
+    dir_x[s] = unit_step.x;
+    dir_y[s] = unit_step.y;
+    outcome[s] = Outcome_e::NONE;
+}
+
+void Kinematics_store::set_speed(int handle, double speed_) {
+    int s = slot_of_handle[handle];
+    speed[s] = speed_;
+    outcome[s] = Outcome_e::NONE;
+}
+
+void Kinematics_store::set_fuel(int handle, double fuel_) {
+    int s = slot_of_handle[handle];
+    fuel[s] = fuel_;
+    outcome[s] = Outcome_e::NONE;
+}
+
+void Kinematics_store::set_destination(int handle, Point destination) {
+    int s = slot_of_handle[handle];
+    dest_x[s] = destination.x;
+    dest_y[s] = destination.y;
+    outcome[s] = Outcome_e::NONE;
+}
+
+void Kinematics_store::set_motion(int handle, Motion_e motion_) {
+    int s = slot_of_handle[handle];
+    motion[s] = motion_;
+    outcome[s] = Outcome_e::NONE;
+}
+
+// Compute one tick of movement for every moving object in slots [begin, end)
+// and leave the results pending; still objects get no result.
+void Kinematics_store::compute_movement(int begin, int end) {
+    Movement_arrays arrays = {x.data(), y.data(), speed.data(), dir_x.data(), dir_y.data(),
+        fuel.data(), fuel_consumption.data(), dest_x.data(), dest_y.data(), motion.data(),
+        next_x.data(), next_y.data(), next_fuel.data(), outcome.data()};
+#ifdef KINEMATICS_HAVE_AVX2_KERNEL
+    static const bool use_avx2 = __builtin_cpu_supports("avx2");
+    if(use_avx2) {
+        compute_movement_avx2(arrays, begin, end);
+        return;
+    }
+#endif
+    compute_movement_scalar(arrays, begin, end);
+}
+
+// Apply the pending result for handle, computing it first if there is none,
+// and return what happened. A Ship that arrived or ran out of fuel is left
+// with zero speed; its Motion_e is for the caller to update.
+Kinematics_store::Outcome_e Kinematics_store::apply_movement(int handle) {
+    int s = slot_of_handle[handle];
+    if(outcome[s] == Outcome_e::NONE) {
+        compute_movement(s, s + 1);
+    }
+    Outcome_e result = outcome[s];
+    if(result != Outcome_e::NONE) {
+        x[s] = next_x[s];
+        y[s] = next_y[s];
+        fuel[s] = next_fuel[s];
+        if(result != Outcome_e::MOVED) {
+            speed[s] = 0.;
+        }
+    }
+    outcome[s] = Outcome_e::NONE;
+    return result;
+}
+
+/*** Closed-form movement ***/
+// Every plain move goes speed nm along the course and burns speed * fuel_consumption
+// tons. The next move is plain while the fuel left is more than that and, when moving
+// to a position, the destination is more than speed nm away.
+int Kinematics_store::ticks_of_plain_movement(int handle) const {
+    int s = slot_of_handle[handle];
+    if(motion[s] == Motion_e::STILL || speed[s] <= 0.) {
+        return INT_MAX;
+    }
+    double plain_ticks = INT_MAX;
+    double fuel_per_tick = speed[s] * fuel_consumption[s];
+    if(fuel_per_tick > 0.) {
+        plain_ticks = min(plain_ticks, floor(fuel[s] / fuel_per_tick) - 2.);
+    }
+    if(motion[s] == Motion_e::TO_POSITION) {
+        double xd = dest_x[s] - x[s];
+        double yd = dest_y[s] - y[s];
+        plain_ticks = min(plain_ticks, floor(sqrt(xd * xd + yd * yd) / speed[s]) - 2.);
+    }
+    return plain_ticks > 0. ? static_cast<int>(plain_ticks) : 0;
+}
+
+// Advance handle by num_ticks plain moves at once
+void Kinematics_store::advance(int handle, int num_ticks) {
+    int s = slot_of_handle[handle];
+    double distance = speed[s] * num_ticks;
+    x[s] += distance * dir_x[s];
+    y[s] += distance * dir_y[s];
+    fuel[s] -= distance * fuel_consumption[s];
+    outcome[s] = Outcome_e::NONE;
+}
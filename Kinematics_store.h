@@ -0,0 +1,113 @@
+/* Kinematics_store class
+The Kinematics_store holds the movement state of every Ship - position, course, speed,
+fuel, fuel consumption, and destination - in one set of contiguous arrays
+(structure-of-arrays), so that the per-tick movement calculation can be run over all
+moving Ships at once instead of one Ship at a time.
+
+Each Ship gets a handle when it is created and keeps it for its lifetime; the handle
+stays valid while the slots behind it are compacted as other Ships go away. Ship's
+accessors read and write its slot through the handle.
+
+compute_movement runs the Ship movement rules (see Ship::calculate_movement) over a
+range of slots and leaves each moving Ship's result pending; apply_movement then copies
+one Ship's pending result into its state. Different slot ranges may be computed
+concurrently. When the CPU supports AVX2 the kernel processes four Ships per step;
+otherwise a scalar loop is used. Both give exactly the same results as the
+one-Ship-at-a-time calculation.
+*/
+#ifndef KINEMATICS_STORE_H
+#define KINEMATICS_STORE_H
+#include "Geometry.h"
+#include "Navigation.h"
+#include <vector>
+
+class Kinematics_store {
+public:
+    // How a Ship is moving, as far as the movement rules are concerned
+    enum class Motion_e : unsigned char { STILL, ON_COURSE, TO_POSITION };
+    // Result of one tick of movement
+    enum class Outcome_e : unsigned char { NONE, MOVED, ARRIVED, OUT_OF_FUEL };
+
+    // static method to get the instance of Kinematics_store
+    static Kinematics_store& get_instance();
+
+    // disallow copy/move construction or assignment
+    Kinematics_store(Kinematics_store& other)=delete;
+    Kinematics_store(Kinematics_store&& other)=delete;
+    Kinematics_store& operator=(Kinematics_store& rhs)=delete;
+    Kinematics_store& operator=(Kinematics_store&& rhs)=delete;
+
+    // add a still object at position with the given fuel state; return its handle
+    int add(Point position, double fuel, double fuel_consumption);
+    // discard the handle and its slot
+    void remove(int handle);
+    // make room for num_objects more objects
+    void reserve(int num_objects);
+    // number of slots in use; compute_movement takes slot numbers in [0, size())
+    int size() const {return static_cast<int>(motion.size());}
+
+    /*** Readers ***/
+    Point get_position(int handle) const
+        {int s = slot_of_handle[handle]; return Point(x[s], y[s]);}
+    Course_speed get_course_speed(int handle) const
+        {int s = slot_of_handle[handle]; return Course_speed(course[s], speed[s]);}
+    double get_course(int handle) const
+        {return course[slot_of_handle[handle]];}
+    double get_speed(int handle) const
+        {return speed[slot_of_handle[handle]];}
+    double get_fuel(int handle) const
+        {return fuel[slot_of_handle[handle]];}
+    Point get_destination(int handle) const
+        {int s = slot_of_handle[handle]; return Point(dest_x[s], dest_y[s]);}
+
+    /*** Writers ***/
+    // writers discard any pending movement result
+    void set_position(int handle, Point position);
+    void set_course(int handle, double course_);
+    void set_speed(int handle, double speed_);
+    void set_fuel(int handle, double fuel_);
+    void set_destination(int handle, Point destination);
+    void set_motion(int handle, Motion_e motion_);
+
+    /*** Movement ***/
+    // Compute one tick of movement for every moving object in slots [begin, end)
+    // and leave the results pending; still objects get no result.
+    void compute_movement(int begin, int end);
+    // Apply the pending result for handle, computing it first if there is none,
+    // and return what happened. A Ship that arrived or ran out of fuel is left
+    // with zero speed; its Motion_e is for the caller to update.
+    Outcome_e apply_movement(int handle);
+    // Discard the pending result for handle, if any
+    void discard_movement(int handle)
+        {outcome[slot_of_handle[handle]] = Outcome_e::NONE;}
+
+    /*** Closed-form movement ***/
+    // Return a number of upcoming ticks for a moving handle that are certain to be
+    // plain moves - no arrival and no running out of fuel. It is kept a couple of
+    // ticks short of the exact count so that rounding cannot carry it past an event.
+    int ticks_of_plain_movement(int handle) const;
+    // Advance handle by num_ticks plain moves at once. The result can differ in the
+    // last bits from num_ticks separate moves, since the steps are not summed one by one.
+    void advance(int handle, int num_ticks);
+
+private:
+    Kinematics_store();
+    ~Kinematics_store() {}
+
+    // Movement state, indexed by slot
+    std::vector<double> x, y;
+    std::vector<double> course, speed;
+    std::vector<double> dir_x, dir_y;       // unit displacement for the current course
+    std::vector<double> fuel, fuel_consumption;
+    std::vector<double> dest_x, dest_y;
+    std::vector<Motion_e> motion;
+    // Pending results of compute_movement, indexed by slot
+    std::vector<double> next_x, next_y, next_fuel;
+    std::vector<Outcome_e> outcome;
+
+    std::vector<int> slot_of_handle;
+    std::vector<int> handle_of_slot;
+    std::vector<int> free_handles;
+};
+
+#endif
@@ -1,9 +1,18 @@
 #include "Model.h"
 #include "Sim_object.h"
 #include "Island.h"
+#include "Event_log.h"
+#include "Kinematics_store.h"
+#include "Name_registry.h"
+#include "Navigation.h"
+#include "Render_thread.h"
 #include "Ship.h"
 #include "View.h"
 #include "Ship_factory.h"
+#include "Scenario.h"
+#include "Snapshot.h"
+#include "Telemetry.h"
+#include "Thread_pool.h"
 #include "Utility.h"
 #include <algorithm>
 #include <iostream>
@@ -12,57 +21,157 @@
 #include <memory>
 #include <vector>
 using std::any_of;
+using std::binary_search;
+using std::function;
 using std::cout;
 using std::endl;
 using std::for_each;
 using std::pair;
-using std::make_shared;
+using std::remove_if;
+using std::allocate_shared;
+using std::min;
 using std::mem_fn;
+using std::move;
 using std::vector;
 using std::set;
 using std::shared_ptr;
+using std::sort;
+using std::static_pointer_cast;
 using std::string;
+using std::unique_ptr;
 using namespace std::placeholders;
 
 using island_pair = pair<string, shared_ptr<Island>>;
 using ship_pair = pair<string, shared_ptr<Ship>>;
 
+// The world the Model starts with; it must not have Cruise_ships or orders, which
+// would need the Model before it is finished
+const char* const default_scenario_c =
+    "island Exxon 10 10 1000 200\n"
+    "island Shell 0 30 1000 200\n"
+    "island Bermuda 20 20\n"
+    "island Treasure_Island 50 5 100 5\n"
+    "ship Ajax Cruiser 15 15\n"
+    "ship Xerxes Cruiser 25 25\n"
+    "ship Valdez Tanker 30 30\n";
+
+// width of a cell of the proximity index grids, in nm
+const double spatial_index_cell_size_c = 10.;
+
 Model& Model::get_instance() {
     static Model m;
     return m;
 }
 
 // Sim_object Name Comparator
-bool Model::Name_Comparator::operator()(shared_ptr<Sim_object> s1, shared_ptr<Sim_object> s2) {
+bool Model::Name_Comparator::operator()(const shared_ptr<Sim_object>& s1, const shared_ptr<Sim_object>& s2) const {
     return s1->get_name() < s2->get_name();
 }
 
-void Model::create_and_insert_island(const string& name_, Point position_,
-                          double fuel_, double production_rate_) {
-    shared_ptr<Island> island_ptr = make_shared<Island>(name_, position_, fuel_, production_rate_);
-    islands.insert(island_pair(name_, island_ptr));
+// create the objects of a scenario and put them into the containers and indexes
+/* The Islands go in first, since a Cruise_ship takes the Model's Islands as its
+unvisited ones when it is created. The scenario lists the Ships in name order, so
+each goes in at the end of the containers. */
+void Model::insert_scenario_objects(const Scenario& scenario) {
+    for(const auto& island : scenario.islands) {
+        insert_island(allocate_shared<Island>(Pool_allocator<Island>(), island.name, island.position,
+                                              island.fuel, island.production_rate));
+    }
+    Name_registry::get_instance().reserve(static_cast<int>(scenario.ships.size()));
+    Kinematics_store::get_instance().reserve(static_cast<int>(scenario.ships.size()));
+    for(const auto& ship : scenario.ships) {
+        insert_ship(create_ship(ship.name, ship.type, ship.position));
+    }
+}
+
+// give the orders of a scenario to its Ships
+void Model::give_scenario_orders(const Scenario& scenario) {
+    using Command_e = Scenario::Order_spec::Command_e;
+    for(const auto& order : scenario.orders) {
+        shared_ptr<Ship> ship_ptr = get_ship_ptr(order.ship_name);
+        switch(order.command) {
+            case Command_e::COURSE:
+                ship_ptr->set_course_and_speed(order.course, order.speed);
+                break;
+            case Command_e::POSITION:
+                ship_ptr->set_destination_position_and_speed(order.position, order.speed);
+                break;
+            case Command_e::DESTINATION:
+                ship_ptr->set_destination_position_and_speed(
+                    get_island_ptr(order.target_name)->get_location(), order.speed);
+                break;
+            case Command_e::LOAD_AT:
+                ship_ptr->set_load_destination(get_island_ptr(order.target_name));
+                break;
+            case Command_e::UNLOAD_AT:
+                ship_ptr->set_unload_destination(get_island_ptr(order.target_name));
+                break;
+            case Command_e::DOCK_AT:
+                ship_ptr->dock(get_island_ptr(order.target_name));
+                break;
+            case Command_e::ATTACK:
+                ship_ptr->attack(get_ship_ptr(order.target_name));
+                break;
+            case Command_e::REFUEL:
+                ship_ptr->refuel();
+                break;
+            case Command_e::STOP:
+                ship_ptr->stop();
+                break;
+            case Command_e::STOP_ATTACK:
+                ship_ptr->stop_attack();
+                break;
+            default:
+                throw Error(default_switch_error_c);
+        }
+    }
+}
+
+// put an object into all of the containers and indexes, awake
+void Model::insert_island(shared_ptr<Island> island_ptr) {
+    islands.insert(island_pair(island_ptr->get_name(), island_ptr));
     all_objects.insert(island_ptr);
+    object_table.insert(island_ptr.get());
+    object_index.insert(island_ptr, island_ptr->get_location());
+    island_catalog.insert(island_ptr);
+}
+
+// Ships are often inserted in name order (from a snapshot, for example), so each
+// insertion is first tried at the end of the containers.
+void Model::insert_ship(shared_ptr<Ship> ship_ptr) {
+    ships.insert(ships.end(), ship_pair(ship_ptr->get_name(), ship_ptr));
+    ships_by_id[ship_ptr->get_id()] = ship_ptr;
+    all_objects.insert(all_objects.end(), ship_ptr);
+    object_table.insert(ship_ptr.get());
+    object_index.insert(ship_ptr, ship_ptr->get_location());
 }
 
-void Model::create_and_insert_ship(const string& name, const string& type,
-                                   Point initial_position) {
-    shared_ptr<Ship> ship_ptr = create_ship(name, type, initial_position);
-    ships.insert(ship_pair(name, ship_ptr));
-    all_objects.insert(ship_ptr);
+// tell the Views every object is gone and empty all of the containers and indexes
+void Model::remove_all_objects() {
+    for(const auto& object_ptr : all_objects) {
+        notify_gone(object_ptr->get_id());
+    }
+    all_objects.clear();
+    object_table.clear();
+    sunk_ships.clear();
+    combat_queue.clear();
+    ships.clear();
+    islands.clear();
+    ships_by_id.clear();
+    object_index.clear();
+    island_catalog.clear();
 }
 
-// create the initial objects, output constructor message
-Model::Model() : time(0) {
-    create_and_insert_island("Exxon", Point(10, 10), 1000, 200);
-    create_and_insert_island("Shell", Point(0, 30), 1000, 200);
-    create_and_insert_island("Bermuda", Point(20, 20));
-    create_and_insert_island("Treasure_Island", Point(50, 5), 100, 5);
-	
-    create_and_insert_ship("Ajax", "Cruiser", Point (15, 15));
-    create_and_insert_ship("Xerxes", "Cruiser", Point (25, 25));
-    create_and_insert_ship("Valdez", "Tanker", Point (30, 30));
+// create the initial objects from the default scenario
+Model::Model() : time(0), object_index(spatial_index_cell_size_c),
+    island_catalog(spatial_index_cell_size_c), renderer(new Render_thread),
+    views_suspended(false), console_events(true), time_skipping(false) {
+    insert_scenario_objects(read_scenario_text(default_scenario_c));
 }
 
+// out of line so that the unique_ptrs see the complete types
+Model::~Model() { }
+
 // is name already in use for either ship or island?
 // either the identical name, or identical in first two characters counts as in-use
 bool Model::is_name_in_use(const string& name) const { // TODO - bind
@@ -95,8 +204,7 @@ bool Model::is_ship_present(const string& name) const {
 
 // add a new ship to the list, and update the view
 void Model::add_ship(shared_ptr<Ship> ship) {
-    all_objects.insert(ship);
-    ships.insert(ship_pair(ship->get_name(), ship));
+    insert_ship(ship);
     ship->broadcast_current_state();
 }
 
@@ -110,71 +218,503 @@ shared_ptr<Ship> Model::get_ship_ptr(const string& name) const {
     }
 }
 
+// the ship of that name, or nullptr if there is none
+shared_ptr<Ship> Model::find_ship(const string& name) const {
+    auto ip = ships.find(name);
+    return ip == ships.end() ? nullptr : ip->second;
+}
+
 // tell all objects to describe themselves
 void Model::describe() const {
     for_each(all_objects.begin(), all_objects.end(), mem_fn(&Sim_object::describe));
 }
 
 // increment the time, and tell all objects to update themselves
+/* The tick runs in two phases. In the compute phase the Kinematics_store works out
+every moving Ship's movement from the state left by the previous tick in one batch,
+split across the worker pool if there is one; nothing else is touched, so the order
+does not matter. In the commit phase the objects are updated in name order, straight
+from the Object_table's arrays by kind (see Object_table.h), applying the prepared
+movement and every effect on other objects (refueling, hits, docking) and producing
+all output, so the result does not depend on the number of threads. An object that
+is idle after its update is put to sleep until it is woken. Sleeping objects would
+only print their status, so they are skipped while console events are off, and no
+events are formatted at all then (see Event_log); while they are on, every object is
+updated so that the output is complete.
+Finally the proximity index takes in the tick's moves, region by region, and the
+Views are given the tick's changes in one batch. */
 void Model::update() {
     ++time;
-    for_each(all_objects.begin(), all_objects.end(), mem_fn(&Sim_object::update));
+    Cout_redirect output_redirect(console_events ? cout.rdbuf() : &discarded_output);
+    Event_log::Suppression quiet_events(!console_events);
+    Kinematics_store& kinematics = Kinematics_store::get_instance();
+    if(worker_pool) {
+        worker_pool->parallel_for(kinematics.size(),
+                                  [&kinematics](int begin, int end)
+                                    { kinematics.compute_movement(begin, end); });
+    } else {
+        kinematics.compute_movement(0, kinematics.size());
+    }
+    if(console_events) {
+        object_table.update_all();
+    } else {
+        object_table.update_awake();
+    }
+    combat_queue.resolve();
+    remove_sunk_ships();
+    if(telemetry && telemetry->is_due(time)) {
+        write_telemetry();
+    }
+    object_index.refresh(worker_pool.get());
+    flush_view_updates();
+}
+
+// update() num_ticks times without notifying the Views along the way, then
+// bring every View up to date with the current state of all objects
+// Views are still told at once about Ships that are sunk.
+void Model::fast_forward(int num_ticks) {
+    views_suspended = true;
+    try {
+        int ticks_left = num_ticks;
+        while(ticks_left > 0) {
+            int ticks_to_skip = (time_skipping && !console_events) ? ticks_until_next_event(ticks_left) : 0;
+            // the ticks to be recorded are run rather than skipped
+            if(telemetry) {
+                ticks_to_skip = min(ticks_to_skip, telemetry->ticks_until_due(time));
+            }
+            if(ticks_to_skip > 0) {
+                skip_ticks(ticks_to_skip);
+                ticks_left -= ticks_to_skip;
+            } else {
+                update();
+                --ticks_left;
+            }
+        }
+    } catch(...) {
+        resume_views();
+        throw;
+    }
+    resume_views();
+}
+
+// let notifications through again and send every object's current state
+void Model::resume_views() {
+    views_suspended = false;
+    broadcast_all_objects();
+    flush_view_updates();
+}
+
+// send every object's current state to the Views
+/* Nothing needs doing without Views: the proximity indexes already follow every
+move, and are filled with the right locations when objects are inserted. */
+void Model::broadcast_all_objects() {
+    if(view_list.empty()) {
+        return;
+    }
+    for_each(all_objects.begin(), all_objects.end(), mem_fn(&Sim_object::broadcast_current_state));
+}
+
+// number of ticks every awake object can skip, at most max_ticks
+/* Any update can change what any other object will do next, so the predictions
+are taken afresh after every tick that is actually run; a scan is as cheap as
+keeping them in a priority queue that would have to be rebuilt each time. */
+int Model::ticks_until_next_event(int max_ticks) const {
+    return object_table.ticks_until_next_event(max_ticks);
+}
+
+// advance the time by num_ticks and have every awake object skip them
+void Model::skip_ticks(int num_ticks) {
+    time += num_ticks;
+    object_table.skip_ticks(num_ticks);
+    object_index.refresh(worker_pool.get());
+}
+
+// Use num_threads threads for the compute phase of update(); 1 means serial.
+// Output is the same for any number of threads.
+void Model::set_worker_threads(int num_threads) {
+    if(num_threads > 1) {
+        worker_pool.reset(new Thread_pool(num_threads));
+    } else {
+        worker_pool.reset();
+    }
 }
 
 /* View services */
 // Attaching a View adds it to the container and causes it to be updated
 // with all current objects'location (or other state information.
 void Model::attach(shared_ptr<View> view) {
+    flush_view_updates();
     view_list.push_back(view);
-    for_each(all_objects.begin(), all_objects.end(), mem_fn(&Sim_object::broadcast_current_state));
+    broadcast_all_objects();
+    flush_view_updates();
 }
 
 // Detach the View by discarding the supplied pointer from the container of Views
 // - no updates sent to it thereafter.
 void Model::detach(shared_ptr<View> view) {
     view_list.remove(view);
+    interest_members.erase(view.get());
 }
 
-// Draw all Views in the view_list
+// Captures a frame from every View and has them drawn, on the render thread
+// unless cout is redirected
+/* A redirected cout must get the frames before the redirection ends, so they are
+drawn on the spot. */
 void Model::draw_views() {
-    for_each(view_list.begin(), view_list.end(), mem_fn(&View::draw));
+    flush_view_updates();
+    vector<unique_ptr<View_frame>> frames;
+    for(const auto& view_ptr : view_list) {
+        frames.push_back(view_ptr->capture_frame());
+    }
+    if(renderer->is_routing_cout()) {
+        renderer->publish(move(frames));
+        return;
+    }
+    for(const auto& frame_ptr : frames) {
+        frame_ptr->draw(cout);
+    }
 }
 
 // notify the views about an object's location
-void Model::notify_location(const string& name, Point location) {
-    for_each(view_list.begin(), view_list.end(),
-             [&name, &location](shared_ptr<View> vp)
-                { vp->update_location(name, location); });
-    
+// The proximity index catches up with the move at the end of the tick.
+void Model::notify_location(int id, Point location) {
+    object_index.mark_moved(id);
+    if(views_suspended || view_list.empty()) {
+        return;
+    }
+    View_update& update = get_pending_update(id);
+    update.fields |= View_update::LOCATION;
+    update.location = location;
 }
 
-// notify the views that an object is now gone
-void Model::notify_gone(const string& name) {
-    for_each(view_list.begin(), view_list.end(), bind(&View::update_remove, _1, name));
+// notify the views and the telemetry that an object is now gone
+void Model::notify_gone(int id) {
+    if(telemetry) {
+        telemetry->remove_object(id);
+    }
+    if(view_list.empty()) {
+        return;
+    }
+    View_update& update = get_pending_update(id);
+    update.fields = View_update::GONE;
 }
 
 // Update ship fuel
-void Model::notify_fuel(const string& name, double fuel) {
-    for_each(view_list.begin(), view_list.end(), bind(&View::update_fuel, _1, name, fuel));
+void Model::notify_fuel(int id, double fuel) {
+    if(views_suspended || view_list.empty()) {
+        return;
+    }
+    View_update& update = get_pending_update(id);
+    update.fields |= View_update::FUEL;
+    update.fuel = fuel;
 }
 
 // Update ship speed
-void Model::notify_course_and_speed(const string& name, double course, double speed) {
-    for_each(view_list.begin(), view_list.end(),
-             [&name, &course, &speed](shared_ptr<View> vp) { vp->update_course_and_speed(name, course, speed); });
+void Model::notify_course_and_speed(int id, double course, double speed) {
+    if(views_suspended || view_list.empty()) {
+        return;
+    }
+    View_update& update = get_pending_update(id);
+    update.fields |= View_update::COURSE_AND_SPEED;
+    update.course = course;
+    update.speed = speed;
+}
+
+// the pending update for id, to which more changes can be added
+/* Changes to an object after it is gone go into a new update, so that the Views
+see the removal before the object comes back. */
+View_update& Model::get_pending_update(int id) {
+    int* position = pending_update_positions.find(id);
+    if(position && !(pending_view_updates[*position].fields & View_update::GONE)) {
+        return pending_view_updates[*position];
+    }
+    pending_update_positions[id] = static_cast<int>(pending_view_updates.size());
+    pending_view_updates.push_back(View_update{id, 0, Point(), 0., 0., 0.});
+    return pending_view_updates.back();
 }
 
-// remove the Ship from the containers.
+// hand the pending updates to every View and start a new batch
+/* Each View gets only the updates its interest asks for; a View interested in
+everything gets the batch as it is. */
+void Model::flush_view_updates() {
+    if(pending_view_updates.empty()) {
+        return;
+    }
+    ship_view_updates.clear();
+    for(const auto& view_ptr : view_list) {
+        View_interest interest = view_ptr->get_interest();
+        switch(interest.kind) {
+            case View_interest::Kind_e::ALL:
+                view_ptr->apply_updates(pending_view_updates);
+                break;
+            case View_interest::Kind_e::SHIPS_ONLY:
+                if(ship_view_updates.empty()) {
+                    for(const View_update& update : pending_view_updates) {
+                        if((update.fields & View_update::GONE) || ships_by_id.find(update.id)) {
+                            ship_view_updates.push_back(update);
+                        }
+                    }
+                }
+                view_ptr->apply_updates(ship_view_updates);
+                break;
+            case View_interest::Kind_e::RADIUS:
+            case View_interest::Kind_e::BOX:
+                flush_region_updates(*view_ptr, interest);
+                break;
+        }
+    }
+    for(const View_update& update : pending_view_updates) {
+        pending_update_positions.erase(update.id);
+    }
+    pending_view_updates.clear();
+}
+
+// hand a View the pending updates for the objects in its interest region, and
+// tell it which objects have entered or left the region
+/* The region's members are found with the proximity index, which is up to date at
+the end of each tick. Pending updates go through for objects that were and still
+are members, and removals go through for members that are gone. A newcomer gets its
+whole current state instead of whatever changed, since the View has not been keeping
+track of it; a member that has moved out of the region gets a LEFT update, unless
+its last update was a removal. A region around an object that is not present is
+empty. */
+void Model::flush_region_updates(View& view, const View_interest& interest) {
+    vector<shared_ptr<Sim_object>>& found = region_objects;
+    found.clear();
+    if(interest.kind == View_interest::Kind_e::RADIUS) {
+        if(const Point* center = object_index.find_location(interest.tracked_id)) {
+            object_index.find_within(*center, interest.radius, found);
+        }
+    } else {
+        // look within the circle around the box, then keep what is inside
+        Point center((interest.lower_left.x + interest.upper_right.x) / 2.,
+                     (interest.lower_left.y + interest.upper_right.y) / 2.);
+        object_index.find_within(center, cartesian_distance(center, interest.upper_right), found);
+        auto outside = [&interest](const shared_ptr<Sim_object>& object_ptr) {
+            Point location = object_ptr->get_location();
+            return location.x < interest.lower_left.x || location.x > interest.upper_right.x
+                || location.y < interest.lower_left.y || location.y > interest.upper_right.y;
+        };
+        found.erase(remove_if(found.begin(), found.end(), outside), found.end());
+    }
+    vector<int>& members = region_members;
+    members.clear();
+    for(const auto& object_ptr : found) {
+        members.push_back(object_ptr->get_id());
+    }
+    sort(members.begin(), members.end());
+    vector<int>& old_members = interest_members[&view];
+    auto is_member = [](const vector<int>& ids, int id) {
+        return binary_search(ids.begin(), ids.end(), id);
+    };
+
+    vector<View_update>& updates = region_view_updates;
+    updates.clear();
+    for(const View_update& update : pending_view_updates) {
+        if(!is_member(old_members, update.id)) {
+            continue;
+        }
+        if((update.fields & View_update::GONE) || is_member(members, update.id)) {
+            updates.push_back(update);
+        }
+    }
+    for(int id : old_members) {
+        if(is_member(members, id)) {
+            continue;
+        }
+        const int* position = pending_update_positions.find(id);
+        if(!position || !(pending_view_updates[*position].fields & View_update::GONE)) {
+            updates.push_back(View_update{id, View_update::LEFT, Point(), 0., 0., 0.});
+        }
+    }
+    for(const auto& object_ptr : found) {
+        int id = object_ptr->get_id();
+        if(is_member(old_members, id)) {
+            continue;
+        }
+        View_update update{id, static_cast<unsigned char>(View_update::ENTERED | View_update::LOCATION),
+                           object_ptr->get_location(), 0., 0., 0.};
+        if(const shared_ptr<Ship>* ship_ptr = ships_by_id.find(id)) {
+            update.fields |= View_update::FUEL | View_update::COURSE_AND_SPEED;
+            update.fuel = (*ship_ptr)->get_fuel();
+            update.course = (*ship_ptr)->get_course_speed().course;
+            update.speed = (*ship_ptr)->get_course_speed().speed;
+        }
+        updates.push_back(update);
+    }
+    old_members.swap(members);
+    found.clear();
+    if(!updates.empty()) {
+        view.apply_updates(updates);
+    }
+}
+
+// stop updating a sunk Ship; it is removed from the containers at the end of the
+// tick, so that nothing being updated goes away underneath the update
 void Model::remove_ship(shared_ptr<Ship> ship_ptr) {
-    all_objects.erase(ship_ptr);
-    ships.erase(ship_ptr->get_name());
+    object_table.remove(ship_ptr.get());
+    // the Ship lives on until the end of the tick, but no handle may reach it any more
+    Ship_handle_table::get_instance().release(ship_ptr->get_handle());
+    sunk_ships.push_back(ship_ptr);
+}
+
+// remove the Ships sunk during this tick from the containers
+void Model::remove_sunk_ships() {
+    for(const auto& ship_ptr : sunk_ships) {
+        all_objects.erase(ship_ptr);
+        ships.erase(ship_ptr->get_name());
+        ships_by_id.erase(ship_ptr->get_id());
+        object_index.remove(ship_ptr.get());
+    }
+    sunk_ships.clear();
+}
+
+/* Snapshots */
+// write the time and the complete state of every object to a snapshot file
+/* The Ships' types and names all come before any Ship's state, so that on loading
+every Ship exists by the time a reference to it is read. */
+void Model::save(const string& filename) const {
+    Snapshot_writer writer(filename);
+    writer.write_int(time);
+    writer.write_count(islands.size());
+    for(const auto& name_island_pair : islands) {
+        writer.write_string(name_island_pair.first);
+        name_island_pair.second->save_state(writer);
+    }
+    writer.write_count(ships.size());
+    for(const auto& name_ship_pair : ships) {
+        writer.write_string(name_ship_pair.second->get_type_name());
+        writer.write_string(name_ship_pair.first);
+    }
+    for(const auto& name_ship_pair : ships) {
+        name_ship_pair.second->save_state(writer);
+    }
+    writer.close();
+}
+
+// replace the time and all objects with those in a snapshot file and bring the
+// Views up to date; if the file cannot be loaded, nothing is changed.
+/* The new objects are built and filled in on the side, and only swapped in once
+the whole file has been read. */
+void Model::load(const string& filename) {
+    Snapshot_reader reader(filename);
+    int loaded_time = reader.read_int();
+    vector<shared_ptr<Island>> loaded_islands(reader.read_count());
+    for(auto& island_ptr : loaded_islands) {
+        island_ptr = allocate_shared<Island>(Pool_allocator<Island>(), reader.read_string(), Point(0., 0.));
+        island_ptr->load_state(reader);
+        reader.add_island(island_ptr);
+    }
+    shared_ptr<const Island_catalog::Edition> loaded_edition = island_catalog.make_edition(loaded_islands);
+    reader.set_island_edition(loaded_edition);
+    vector<shared_ptr<Ship>> loaded_ships(reader.read_count());
+    Name_registry::get_instance().reserve(static_cast<int>(loaded_ships.size()));
+    Kinematics_store::get_instance().reserve(static_cast<int>(loaded_ships.size()));
+    for(auto& ship_ptr : loaded_ships) {
+        string type = reader.read_string();
+        ship_ptr = create_ship(reader.read_string(), type, Point(0., 0.));
+        reader.add_ship(ship_ptr);
+    }
+    for(const auto& ship_ptr : loaded_ships) {
+        ship_ptr->load_state(reader);
+    }
+    if(!reader.at_end()) {
+        throw Error("Invalid snapshot file!");
+    }
+    
+    remove_all_objects();
+    time = loaded_time;
+    for_each(loaded_islands.begin(), loaded_islands.end(), [this](shared_ptr<Island> island_ptr) { insert_island(island_ptr); });
+    // the loaded Ships' itineraries refer to this Edition
+    island_catalog.use_edition(loaded_edition);
+    for_each(loaded_ships.begin(), loaded_ships.end(), [this](shared_ptr<Ship> ship_ptr) { insert_ship(ship_ptr); });
+    broadcast_all_objects();
 }
 
-// Return a set of Island location Points
-vector<shared_ptr<Island>> Model::get_islands() {
-    vector<shared_ptr<Island>> island_locations;
-    for(island_pair island_pr : islands) {
-        island_locations.push_back(island_pr.second);
+/* Telemetry */
+// record the state of every object to a telemetry file (see Telemetry.h) at the
+// end of every update whose time is a multiple of interval, starting with the
+// next; fast_forward does not skip over those updates
+void Model::open_telemetry(const string& filename, int interval) {
+    if(telemetry) {
+        throw Error("Telemetry is already open!");
+    }
+    telemetry.reset(new Telemetry_writer(filename, interval));
+}
+
+// finish the telemetry file
+/* The writer is let go of even if the file could not be finished. */
+void Model::close_telemetry() {
+    if(!telemetry) {
+        throw Error("No telemetry is open!");
+    }
+    unique_ptr<Telemetry_writer> closing = move(telemetry);
+    closing->close();
+}
+
+// write the state of every object to the telemetry, Islands first, each in name order
+void Model::write_telemetry() {
+    Telemetry_record record;
+    telemetry->begin_tick(time);
+    for(const auto& name_island_pair : islands) {
+        name_island_pair.second->report_telemetry(record);
+        telemetry->add_object(name_island_pair.second->get_id(), "Island", name_island_pair.first, record);
+    }
+    for(const auto& name_ship_pair : ships) {
+        name_ship_pair.second->report_telemetry(record);
+        telemetry->add_object(name_ship_pair.second->get_id(), name_ship_pair.second->get_type_name(),
+                              name_ship_pair.first, record);
     }
-    return island_locations;
-}
\ No newline at end of file
+    telemetry->end_tick();
+}
+
+/* Scenarios */
+// replace all objects with those described in a scenario file (see Scenario.h),
+// give them their orders without any output, reset the time to 0, and bring
+// the Views up to date; if the file cannot be read, nothing is changed.
+/* The whole file is read and checked before anything is removed. The Views are
+brought up to date even if a Ship refuses an order. */
+void Model::load_scenario(const string& filename) {
+    Scenario scenario = read_scenario_file(filename);
+    remove_all_objects();
+    time = 0;
+    insert_scenario_objects(scenario);
+    try {
+        Cout_redirect quiet(&discarded_output);
+        Event_log::Suppression quiet_events(true);
+        give_scenario_orders(scenario);
+    } catch(...) {
+        broadcast_all_objects();
+        throw;
+    }
+    broadcast_all_objects();
+}
+
+// make sure the object is updated until it is idle again; call after giving it
+// orders, and whenever one object changes the state of another
+void Model::wake(shared_ptr<Sim_object> object_ptr) {
+    object_table.wake(object_ptr.get());
+}
+
+/* Proximity queries, answered from a grid index of object locations */
+// return all objects within radius of center (inclusive), in name order
+vector<shared_ptr<Sim_object>> Model::objects_within(Point center, double radius) const {
+    vector<shared_ptr<Sim_object>> found;
+    object_index.find_within(center, radius, found);
+    sort(found.begin(), found.end(), Name_Comparator());
+    return found;
+}
+
+// return the Island nearest to location, skipping those for which exclude returns true,
+// as Cruise_ships have always chosen it: the first Island in name order, unless a later
+// one is at least 1 nm closer than the one chosen so far. nullptr if every Island is excluded.
+shared_ptr<Island> Model::nearest_island(Point location,
+                            const function<bool(const shared_ptr<Island>&)>& exclude) const {
+    return island_catalog.nearest(location, exclude);
+}
+
+// the Islands as they are now, in name order; the Edition never changes, and
+// the same one is handed out until Islands are added or removed (see Island_catalog)
+shared_ptr<const Island_catalog::Edition> Model::get_islands() const {
+    return island_catalog.get_edition();
+}
@@ -2,9 +2,11 @@
 Model is part of a simplified Model-View-Controller pattern.
 Model keeps track of the Sim_objects in our little world. It is the only
 component that knows how many Islands and Ships there are, but it does not
-know about any of their derived classes, nor which Ships are of what kind of Ship. 
+know about any of their derived classes, nor which Ships are of what kind of Ship;
+the Object_table it updates them through does. 
 It has facilities for looking up objects by name, and removing Ships.  When
-created, it creates an initial group of Islands and Ships using the Ship_factory.
+created, it creates an initial group of Islands and Ships from a built-in scenario
+(see Scenario.h) using the Ship_factory; load_scenario replaces them with another.
 Finally, it keeps the system's time.
 
 Controller tells Model what to do; Model in turn tells the objects what do, and
@@ -13,16 +15,29 @@ Model also provides facilities for looking up objects given their name.
 */
 #ifndef MODEL_H
 #define MODEL_H
+#include <functional>
 #include <map>
 #include <memory>
+#include <utility>
 #include <set>
 #include <list>
 #include <cstring>
 #include <vector>
+#include "Combat_queue.h"
+#include "Id_map.h"
+#include "Island_catalog.h"
+#include "Object_pool.h"
+#include "Object_table.h"
+#include "Spatial_grid.h"
+#include "Utility.h"
+#include "View.h"
 class Sim_object;
 class Island;
 class Ship;
-class View;
+class Render_thread;
+class Thread_pool;
+class Telemetry_writer;
+struct Scenario;
 struct Point;
 
 class Model {
@@ -54,11 +69,33 @@ public:
     void add_ship(std::shared_ptr<Ship>);
 	// will throw Error("Ship not found!") if no ship of that name
     std::shared_ptr<Ship> get_ship_ptr(const std::string& name) const;
+    // the ship of that name, or nullptr if there is none
+    std::shared_ptr<Ship> find_ship(const std::string& name) const;
 	
 	// tell all objects to describe themselves
 	void describe() const;
 	// increment the time, and tell all objects to update themselves
 	void update();	
+    // Use num_threads threads for the compute phase of update(); 1 means serial.
+    // Output is the same for any number of threads.
+    void set_worker_threads(int num_threads);
+    // update() num_ticks times without notifying the Views along the way, then
+    // bring every View up to date with the current state of all objects
+    void fast_forward(int num_ticks);
+    // turn the messages objects print while updating on or off
+    void set_console_events(bool enabled) {console_events = enabled;}
+    bool get_console_events() const {return console_events;}
+    // When time skipping is on and console events are off, fast_forward jumps over
+    // stretches of ticks in which every object just carries on (see
+    // Sim_object::ticks_until_event) instead of running them one at a time.
+    // Positions and fuel computed across a jump can differ in the last bits from
+    // those computed tick by tick.
+    void set_time_skipping(bool enabled) {time_skipping = enabled;}
+    bool get_time_skipping() const {return time_skipping;}
+    // turn resolving the shots fired in a tick all together after the objects are
+    // updated on or off (see Combat_queue); off carries out each shot as it is fired
+    void set_batched_combat(bool enabled) {combat_queue.set_batched(enabled);}
+    bool get_batched_combat() const {return combat_queue.get_batched();}
     
 	/* View services */
 	// Attaching a View adds it to the container and causes it to be updated
@@ -67,41 +104,149 @@ public:
 	// Detach the View by discarding the supplied pointer from the container of Views
     // - no updates sent to it thereafter.
     void detach(std::shared_ptr<View>);
-    // Iterates over all View* and calls draw()
+    // Captures a frame from every View and has them drawn, on the render thread
+    // unless cout is redirected
     void draw_views();
 	
+    // Objects are identified to the Views by their interned IDs (see Name_registry)
+    // Notifications are collected and handed to the Views in one batch at the end
+    // of each tick, when a View is attached, and before the Views draw.
     // notify the views about an object's location
-	void notify_location(const std::string& name, Point location);
-	// notify the views that an object is now gone
-	void notify_gone(const std::string& name);
+	void notify_location(int id, Point location);
+	// notify the views and the telemetry that an object is now gone
+	void notify_gone(int id);
     // Update ship fuel
-    void notify_fuel(const std::string& name, double fuel);
+    void notify_fuel(int id, double fuel);
     // Update ship speed
-    void notify_course_and_speed(const std::string& name, double course, double speed);
+    void notify_course_and_speed(int id, double course, double speed);
     
-    // remove the Ship from the containers.
+    // stop updating a sunk Ship; it is removed from the containers at the end of the
+    // tick, so that nothing being updated goes away underneath the update
     void remove_ship(std::shared_ptr<Ship> ship_ptr);
-    // Return a set of Island location Points
-    std::vector<std::shared_ptr<Island>> get_islands();
+    // queue a shot by attacker at target, to be carried out by the Combat_queue
+    void fire(const Ship& attacker, const Ship& target, int firepower)
+        {combat_queue.add_shot(attacker, target, firepower);}
+    // make sure the object is updated until it is idle again; call after giving it
+    // orders, and whenever one object changes the state of another
+    void wake(std::shared_ptr<Sim_object> object_ptr);
+
+    /* Snapshots */
+    // write the time and the complete state of every object to a snapshot file
+    // may throw Error("Could not open file!") or Error("Could not write file!")
+    void save(const std::string& filename) const;
+    // replace the time and all objects with those in a snapshot file and bring the
+    // Views up to date; if the file cannot be loaded, nothing is changed.
+    // may throw Error("Could not open file!"), Error("Invalid snapshot file!"),
+    // or Error("Unsupported snapshot version!")
+    void load(const std::string& filename);
+
+    /* Scenarios */
+    // replace all objects with those described in a scenario file (see Scenario.h),
+    // give them their orders without any output, reset the time to 0, and bring
+    // the Views up to date; if the file cannot be read, nothing is changed.
+    // may throw Error("Could not open file!") or Error("Invalid scenario file!"),
+    // or, once the objects are in place, any Error a Ship gives for an order it refuses
+    void load_scenario(const std::string& filename);
+
+    /* Telemetry */
+    // record the state of every object to a telemetry file (see Telemetry.h) at the
+    // end of every update whose time is a multiple of interval, starting with the
+    // next; fast_forward does not skip over those updates
+    // may throw Error("Telemetry is already open!") or Error("Could not open file!")
+    void open_telemetry(const std::string& filename, int interval);
+    // finish the telemetry file
+    // may throw Error("No telemetry is open!") or Error("Could not write file!")
+    void close_telemetry();
+
+    /* Proximity queries, answered from a grid index of object locations */
+    // Moves are taken into the index at the end of each tick, by region and in
+    // parallel when there are worker threads (see Spatial_grid).
+    // return all objects within radius of center (inclusive), in name order
+    std::vector<std::shared_ptr<Sim_object>> objects_within(Point center, double radius) const;
+    // return the Island nearest to location, skipping those for which exclude returns true,
+    // as Cruise_ships have always chosen it: the first Island in name order, unless a later
+    // one is at least 1 nm closer than the one chosen so far. nullptr if every Island is excluded.
+    std::shared_ptr<Island> nearest_island(Point location,
+                        const std::function<bool(const std::shared_ptr<Island>&)>& exclude) const;
+    // the Islands as they are now, in name order; the Edition never changes, and
+    // the same one is handed out until Islands are added or removed (see Island_catalog)
+    std::shared_ptr<const Island_catalog::Edition> get_islands() const;
 private:
-    // create the initial objects, output constructor message
+    // create the initial objects from the default scenario
     Model();
-    ~Model() {};
+    ~Model();
     
     struct Name_Comparator {
-        bool operator() (std::shared_ptr<Sim_object> s1, std::shared_ptr<Sim_object> s2);
+        bool operator() (const std::shared_ptr<Sim_object>& s1, const std::shared_ptr<Sim_object>& s2) const;
     };
     
 	int time;		// the simulated time
-    std::set<std::shared_ptr<Sim_object>, Name_Comparator> all_objects;
-    std::map<std::string, std::shared_ptr<Ship>> ships;
-    std::map<std::string, std::shared_ptr<Island>> islands;
+    // the containers of objects keep their nodes in the object pools (see Object_pool.h)
+    using Object_set = std::set<std::shared_ptr<Sim_object>, Name_Comparator,
+                                Pool_allocator<std::shared_ptr<Sim_object>>>;
+    template<typename T>
+    using Name_map = std::map<std::string, std::shared_ptr<T>, std::less<std::string>,
+                              Pool_allocator<std::pair<const std::string, std::shared_ptr<T>>>>;
+
+    Object_set all_objects;
+    // every object again, by kind, for updating; it also knows which are awake
+    Object_table object_table;
+    Name_map<Ship> ships;
+    Name_map<Island> islands;
+    Id_map<std::shared_ptr<Ship>> ships_by_id;
     std::list<std::shared_ptr<View>> view_list;
+    // changes not yet handed to the Views, at most one per object (see View.h)
+    std::vector<View_update> pending_view_updates;
+    Id_map<int> pending_update_positions;
+    // scratch space for each tick, kept so that its storage is reused
+    std::vector<View_update> ship_view_updates;
+    std::vector<View_update> region_view_updates;
+    std::vector<std::shared_ptr<Sim_object>> region_objects;
+    std::vector<int> region_members;
+    // for each View interested in a region, the sorted ids of the objects it was
+    // last told are in the region
+    std::map<const View*, std::vector<int>> interest_members;
+    // Ships sunk during this tick, still to be removed from the containers
+    std::vector<std::shared_ptr<Ship>> sunk_ships;
+    Combat_queue combat_queue;
+    Spatial_grid object_index;      // every object
+    Island_catalog island_catalog;  // Islands only
+    std::unique_ptr<Thread_pool> worker_pool;   // nullptr when updating serially
+    std::unique_ptr<Render_thread> renderer;    // draws the Views' frames
+    std::unique_ptr<Telemetry_writer> telemetry;    // nullptr when none is open
+    bool views_suspended;       // true while fast_forward holds back notifications
+    bool console_events;        // false to discard output from updates
+    bool time_skipping;         // true to let fast_forward jump over uneventful ticks
+    Null_streambuf discarded_output;
     
-    void create_and_insert_island(const std::string& name_, Point position_,
-                              double fuel_ = 0., double production_rate_ = 0.);
-    void create_and_insert_ship(const std::string& name, const std::string& type,
-                                Point initial_position);
+    // create the objects of a scenario and put them into the containers and indexes
+    void insert_scenario_objects(const Scenario& scenario);
+    // give the orders of a scenario to its Ships
+    void give_scenario_orders(const Scenario& scenario);
+    // put an object into all of the containers and indexes, awake
+    void insert_island(std::shared_ptr<Island> island_ptr);
+    void insert_ship(std::shared_ptr<Ship> ship_ptr);
+    // remove the Ships sunk during this tick from the containers
+    void remove_sunk_ships();
+    // write the state of every object to the telemetry, Islands first, each in name order
+    void write_telemetry();
+    // tell the Views every object is gone and empty all of the containers and indexes
+    void remove_all_objects();
+    // let notifications through again and send every object's current state
+    void resume_views();
+    // send every object's current state to the Views
+    void broadcast_all_objects();
+    // the pending update for id, to which more changes can be added
+    View_update& get_pending_update(int id);
+    // hand the pending updates to every View and start a new batch
+    void flush_view_updates();
+    // hand a View the pending updates for the objects in its interest region, and
+    // tell it which objects have entered or left the region
+    void flush_region_updates(View& view, const View_interest& interest);
+    // number of ticks every awake object can skip, at most max_ticks
+    int ticks_until_next_event(int max_ticks) const;
+    // advance the time by num_ticks and have every awake object skip them
+    void skip_ticks(int num_ticks);
 };
 
 #endif
@@ -0,0 +1,40 @@
+#include "Name_registry.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+using std::lower_bound;
+using std::string;
+
+Name_registry& Name_registry::get_instance() {
+    static Name_registry registry;
+    return registry;
+}
+
+// make room for num_names more names
+void Name_registry::reserve(int num_names) {
+    names.reserve(names.size() + num_names);
+    ids_by_name.reserve(names.size() + num_names);
+    ids_in_name_order.reserve(names.size() + num_names);
+}
+
+// return the ID for name, or -1 if it has none
+int Name_registry::find_id(const string& name) const {
+    auto id_it = ids_by_name.find(name);
+    return id_it == ids_by_name.end() ? -1 : id_it->second;
+}
+
+// return the ID for name, giving it the next unused ID if it has none yet
+// New names are rare, so keeping the name order sorted by insertion is cheap enough.
+int Name_registry::intern(const string& name) {
+    int id = size();
+    auto name_id_insertion = ids_by_name.emplace(name, id);
+    if(!name_id_insertion.second) {
+        return name_id_insertion.first->second;
+    }
+    names.push_back(name);
+    auto position_it = lower_bound(ids_in_name_order.begin(), ids_in_name_order.end(), name,
+                                   [this](int other_id, const string& new_name)
+                                        { return names[other_id] < new_name; });
+    ids_in_name_order.insert(position_it, id);
+    return id;
+}
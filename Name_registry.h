@@ -0,0 +1,53 @@
+/* Name_registry class
+The Name_registry interns the names of Sim_objects: each distinct name gets a small
+integer ID, handed out densely from 0 in order of first use, and the same name always
+gets the same ID, even after its object is gone and another takes the name. Model and
+the Views pass and store IDs instead of strings, so that keeping track of an object is
+an array subscript rather than a string-keyed lookup; the name is looked up from its ID
+only when it has to be printed.
+
+The registry also keeps the IDs in alphabetical order of their names, for output that
+must list objects by name.
+*/
+#ifndef NAME_REGISTRY_H
+#define NAME_REGISTRY_H
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Name_registry {
+public:
+    // static method to get the instance of Name_registry
+    static Name_registry& get_instance();
+
+    // disallow copy/move construction or assignment
+    Name_registry(Name_registry& other)=delete;
+    Name_registry(Name_registry&& other)=delete;
+    Name_registry& operator=(Name_registry& rhs)=delete;
+    Name_registry& operator=(Name_registry&& rhs)=delete;
+
+    // return the ID for name, giving it the next unused ID if it has none yet
+    int intern(const std::string& name);
+    // make room for num_names more names
+    void reserve(int num_names);
+    // return the ID for name, or -1 if it has none
+    int find_id(const std::string& name) const;
+    // return the name that id was given for
+    const std::string& get_name(int id) const
+        {return names[id];}
+    // number of IDs given out; every ID is in [0, size())
+    int size() const {return static_cast<int>(names.size());}
+    // every ID given out, in alphabetical order of the names
+    const std::vector<int>& get_ids_in_name_order() const
+        {return ids_in_name_order;}
+
+private:
+    Name_registry() { }
+    ~Name_registry() { }
+
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> ids_by_name;
+    std::vector<int> ids_in_name_order;
+};
+
+#endif
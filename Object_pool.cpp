@@ -0,0 +1,37 @@
+#include "Object_pool.h"
+#include <cstddef>
+#include <new>
+using std::size_t;
+
+// the first chunk of a pool holds this many blocks
+const size_t first_chunk_blocks_c = 64;
+// chunks stop growing once they hold this many blocks
+const size_t max_chunk_blocks_c = 1 << 16;
+
+Block_pool::Block_pool(size_t block_size_) : block_size(block_size_), free_list(nullptr),
+    next_chunk_blocks(first_chunk_blocks_c) { }
+
+// return a block, taking a new chunk from the global allocator if none are free
+void* Block_pool::allocate() {
+    if(!free_list) {
+        char* chunk = static_cast<char*>(::operator new(block_size * next_chunk_blocks));
+        for(size_t i = next_chunk_blocks; i > 0; --i) {
+            Free_block* block = reinterpret_cast<Free_block*>(chunk + (i - 1) * block_size);
+            block->next = free_list;
+            free_list = block;
+        }
+        if(next_chunk_blocks < max_chunk_blocks_c) {
+            next_chunk_blocks *= 2;
+        }
+    }
+    Free_block* block = free_list;
+    free_list = block->next;
+    return block;
+}
+
+// put a block from this pool back on the free list
+void Block_pool::deallocate(void* block) {
+    Free_block* freed = static_cast<Free_block*>(block);
+    freed->next = free_list;
+    free_list = freed;
+}
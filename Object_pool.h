@@ -0,0 +1,100 @@
+/* Object pools
+A Block_pool hands out blocks of one size from chunks it gets from the global
+allocator. Freed blocks go on a free list and are handed out again first, so once a
+pool has grown to the most blocks in use at one time, allocating and freeing take no
+more calls to the global allocator. Chunks are never given back.
+
+A Pool_allocator is a standard allocator that takes single objects from the pool for
+their size, and anything larger from the global allocator. Ships and Islands are
+created with std::allocate_shared and a Pool_allocator, so that the object and its
+shared_ptr control block share one pooled block; the Model's containers of objects
+use it for their nodes. Creating and sinking Ships over and over then reuses the
+same memory instead of going back to the heap each time.
+
+The pools are not thread-safe; only the thread running the simulation may use them.
+*/
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+#include <cstddef>
+#include <new>
+
+class Block_pool {
+public:
+    // the pool for blocks of block_size bytes; it is created on first use and never
+    // destroyed, so that objects freed while the program exits can still go back to it
+    template<std::size_t block_size>
+    static Block_pool& get_pool();
+
+    // disallow copy/move construction or assignment
+    Block_pool(Block_pool& other)=delete;
+    Block_pool(Block_pool&& other)=delete;
+    Block_pool& operator=(Block_pool& rhs)=delete;
+    Block_pool& operator=(Block_pool&& rhs)=delete;
+
+    // return a block, taking a new chunk from the global allocator if none are free
+    void* allocate();
+    // put a block from this pool back on the free list
+    void deallocate(void* block);
+
+private:
+    struct Free_block {
+        Free_block* next;
+    };
+
+    std::size_t block_size;
+    Free_block* free_list;
+    std::size_t next_chunk_blocks;      // each chunk is twice as big as the last
+
+    explicit Block_pool(std::size_t block_size_);
+    ~Block_pool() { }
+};
+
+template<std::size_t block_size>
+Block_pool& Block_pool::get_pool() {
+    static Block_pool* pool = new Block_pool(block_size);
+    return *pool;
+}
+
+// the size of the blocks that objects of object_size bytes are kept in
+constexpr std::size_t pool_block_size(std::size_t object_size)
+{
+    return (object_size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t)
+        * alignof(std::max_align_t);
+}
+
+template<typename T>
+class Pool_allocator {
+public:
+    using value_type = T;
+
+    Pool_allocator() { }
+    template<typename U>
+    Pool_allocator(const Pool_allocator<U>&) { }
+
+    T* allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Pool blocks are not aligned enough!");
+        if(n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(Block_pool::get_pool<pool_block_size(sizeof(T))>().allocate());
+    }
+    void deallocate(T* object_ptr, std::size_t n)
+    {
+        if(n != 1) {
+            ::operator delete(object_ptr);
+            return;
+        }
+        Block_pool::get_pool<pool_block_size(sizeof(T))>().deallocate(object_ptr);
+    }
+};
+
+// Pool_allocators are interchangeable: the pools do not belong to them
+template<typename T, typename U>
+bool operator== (const Pool_allocator<T>&, const Pool_allocator<U>&)
+    {return true;}
+template<typename T, typename U>
+bool operator!= (const Pool_allocator<T>&, const Pool_allocator<U>&)
+    {return false;}
+
+#endif
@@ -0,0 +1,256 @@
+#include "Object_table.h"
+#include "Sim_object.h"
+#include "Island.h"
+#include "Tanker.h"
+#include "Cruiser.h"
+#include "Cruise_ship.h"
+#include "Utility.h"
+#include <algorithm>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+using std::min;
+using std::move;
+using std::vector;
+
+/* The functions of the kinds the table knows are called by their qualified names,
+which does not go through the virtual function table; other kinds are called
+through it. Kinds are told apart by their exact type, so a class derived from one
+of them is an "other" kind and keeps its own overrides. */
+template<typename T>
+static void update_object(T* object_ptr)
+    {object_ptr->T::update();}
+static void update_object(Sim_object* object_ptr)
+    {object_ptr->update();}
+
+template<typename T>
+static bool is_object_idle(const T* object_ptr)
+    {return object_ptr->T::is_idle();}
+static bool is_object_idle(const Sim_object* object_ptr)
+    {return object_ptr->is_idle();}
+
+template<typename T>
+static int object_ticks_until_event(const T* object_ptr)
+    {return object_ptr->T::ticks_until_event();}
+static int object_ticks_until_event(const Sim_object* object_ptr)
+    {return object_ptr->ticks_until_event();}
+
+template<typename T>
+static void skip_object_ticks(T* object_ptr, int num_ticks)
+    {object_ptr->T::skip_ticks(num_ticks);}
+static void skip_object_ticks(Sim_object* object_ptr, int num_ticks)
+    {object_ptr->skip_ticks(num_ticks);}
+
+// add an entry to the end of entries and return its index
+template<typename E>
+static int append_entry(vector<E>& entries, const E& entry) {
+    entries.push_back(entry);
+    return static_cast<int>(entries.size()) - 1;
+}
+
+// add an object, awake
+void Object_table::insert(Sim_object* object_ptr) {
+    const auto& type = typeid(*object_ptr);
+    Place place;
+    if(type == typeid(Island)) {
+        place = Place{Kind_e::ISLAND, append_entry(islands, Entry<Island>{static_cast<Island*>(object_ptr), true})};
+    } else if(type == typeid(Tanker)) {
+        place = Place{Kind_e::TANKER, append_entry(tankers, Entry<Tanker>{static_cast<Tanker*>(object_ptr), true})};
+    } else if(type == typeid(Cruiser)) {
+        place = Place{Kind_e::CRUISER, append_entry(cruisers, Entry<Cruiser>{static_cast<Cruiser*>(object_ptr), true})};
+    } else if(type == typeid(Cruise_ship)) {
+        place = Place{Kind_e::CRUISE_SHIP,
+                      append_entry(cruise_ships, Entry<Cruise_ship>{static_cast<Cruise_ship*>(object_ptr), true})};
+    } else {
+        place = Place{Kind_e::OTHER, append_entry(other_objects, Entry<Sim_object>{object_ptr, true})};
+    }
+    places[object_ptr->get_id()] = place;
+    name_order.push_back(place);
+    out_of_order = true;
+}
+
+// remove an object; no error if it is not present
+void Object_table::remove(const Sim_object* object_ptr) {
+    const Place* place = places.find(object_ptr->get_id());
+    if(!place) {
+        return;
+    }
+    with_entry(*place, [this, object_ptr](auto& entry) {
+        if(entry.object_ptr == object_ptr) {
+            entry.object_ptr = nullptr;
+            places.erase(object_ptr->get_id());
+            ++num_removed;
+        }
+    });
+}
+
+// remove every object
+void Object_table::clear() {
+    islands.clear();
+    tankers.clear();
+    cruisers.clear();
+    cruise_ships.clear();
+    other_objects.clear();
+    name_order.clear();
+    places.clear();
+    num_removed = 0;
+    out_of_order = false;
+}
+
+// wake an object; no effect if it is not present
+void Object_table::wake(const Sim_object* object_ptr) {
+    const Place* place = places.find(object_ptr->get_id());
+    if(!place) {
+        return;
+    }
+    with_entry(*place, [object_ptr](auto& entry) {
+        if(entry.object_ptr == object_ptr) {
+            entry.awake = true;
+        }
+    });
+}
+
+// update every object, in name order
+/* An update can remove another object, which only clears its entry, so the
+arrays stay put while they are walked. */
+void Object_table::update_all() {
+    tidy();
+    for(Place place : name_order) {
+        with_entry(place, [](auto& entry) {
+            if(entry.object_ptr) {
+                update_object(entry.object_ptr);
+            }
+        });
+    }
+}
+
+// update every awake object, in name order, and put to sleep those that are
+// idle afterwards
+void Object_table::update_awake() {
+    tidy();
+    for(Place place : name_order) {
+        with_entry(place, [](auto& entry) {
+            if(!entry.object_ptr || !entry.awake) {
+                return;
+            }
+            update_object(entry.object_ptr);
+            if(entry.object_ptr && is_object_idle(entry.object_ptr)) {
+                entry.awake = false;
+            }
+        });
+    }
+}
+
+// the least number of ticks any awake object can skip, at most max_ticks
+int Object_table::ticks_until_next_event(int max_ticks) const {
+    int ticks = max_ticks;
+    for_each_entry(*this, [&ticks](const auto& entry) {
+        if(ticks > 0 && entry.object_ptr && entry.awake) {
+            ticks = min(ticks, object_ticks_until_event(entry.object_ptr));
+        }
+    });
+    return ticks;
+}
+
+// have every awake object skip num_ticks
+void Object_table::skip_ticks(int num_ticks) {
+    for_each_entry(*this, [num_ticks](auto& entry) {
+        if(entry.object_ptr && entry.awake) {
+            skip_object_ticks(entry.object_ptr, num_ticks);
+        }
+    });
+}
+
+// call f with the Entry at place
+template<typename F>
+void Object_table::with_entry(Place place, F f) {
+    switch(place.kind) {
+        case Kind_e::ISLAND:
+            f(islands[place.index]);
+            break;
+        case Kind_e::TANKER:
+            f(tankers[place.index]);
+            break;
+        case Kind_e::CRUISER:
+            f(cruisers[place.index]);
+            break;
+        case Kind_e::CRUISE_SHIP:
+            f(cruise_ships[place.index]);
+            break;
+        case Kind_e::OTHER:
+            f(other_objects[place.index]);
+            break;
+        default:
+            throw Error(default_switch_error_c);
+    }
+}
+
+// call f with every Entry of table, kind by kind
+template<typename Table, typename F>
+void Object_table::for_each_entry(Table& table, F f) {
+    for(auto& entry : table.islands) {
+        f(entry);
+    }
+    for(auto& entry : table.tankers) {
+        f(entry);
+    }
+    for(auto& entry : table.cruisers) {
+        f(entry);
+    }
+    for(auto& entry : table.cruise_ships) {
+        f(entry);
+    }
+    for(auto& entry : table.other_objects) {
+        f(entry);
+    }
+}
+
+// compact the arrays and put them in name order, if that is due
+/* Removed entries are only worth squeezing out once they are a good part of the
+table; until then they cost a check each. The new order comes from walking the
+places in name order, so no names are compared. */
+void Object_table::tidy() {
+    if(!out_of_order && num_removed * 4 <= static_cast<int>(name_order.size())) {
+        return;
+    }
+    vector<Entry<Island>> old_islands(move(islands));
+    vector<Entry<Tanker>> old_tankers(move(tankers));
+    vector<Entry<Cruiser>> old_cruisers(move(cruisers));
+    vector<Entry<Cruise_ship>> old_cruise_ships(move(cruise_ships));
+    vector<Entry<Sim_object>> old_other_objects(move(other_objects));
+    islands.clear();
+    tankers.clear();
+    cruisers.clear();
+    cruise_ships.clear();
+    other_objects.clear();
+    name_order.clear();
+    places.for_each_in_name_order([&](int, const Place& old_place) {
+        Place place{old_place.kind, 0};
+        switch(old_place.kind) {
+            case Kind_e::ISLAND:
+                place.index = append_entry(islands, old_islands[old_place.index]);
+                break;
+            case Kind_e::TANKER:
+                place.index = append_entry(tankers, old_tankers[old_place.index]);
+                break;
+            case Kind_e::CRUISER:
+                place.index = append_entry(cruisers, old_cruisers[old_place.index]);
+                break;
+            case Kind_e::CRUISE_SHIP:
+                place.index = append_entry(cruise_ships, old_cruise_ships[old_place.index]);
+                break;
+            case Kind_e::OTHER:
+                place.index = append_entry(other_objects, old_other_objects[old_place.index]);
+                break;
+            default:
+                throw Error(default_switch_error_c);
+        }
+        name_order.push_back(place);
+    });
+    // the places can only be changed once the walk over them is done
+    for(const Place& place : name_order) {
+        with_entry(place, [this, place](auto& entry) { places[entry.object_ptr->get_id()] = place; });
+    }
+    num_removed = 0;
+    out_of_order = false;
+}
@@ -0,0 +1,95 @@
+/* Object_table class
+An Object_table keeps the objects that the Model updates each tick in dense arrays,
+one for each kind of object - Islands, Tankers, Cruisers and Cruise_ships - so that a
+tick walks arrays rather than a tree, and calls each object's functions directly
+rather than through Sim_object's virtual functions. Objects must be updated in name
+order for their output and their effects on each other to come out the same, so the
+table also keeps a list of where each object is, in name order across all kinds.
+Work that does not depend on the order, such as time skipping, goes through each
+array in turn.
+
+Each entry records whether its object is awake (see Model::update); update_awake and
+time skipping leave asleep objects alone.
+
+A removed object is only marked as gone. Once objects have been added, or many have
+been removed, the arrays are compacted and put back in name order before the next
+update. The Model owns the objects; the table only points to them, and objects must
+not be added while it is updating them.
+
+Like the Ship_factory, the table knows the kinds of Sim_object. An object of any
+other kind is kept in an array of its own and called through the virtual functions.
+*/
+#ifndef OBJECT_TABLE_H
+#define OBJECT_TABLE_H
+#include "Id_map.h"
+#include <vector>
+
+class Sim_object;
+class Island;
+class Tanker;
+class Cruiser;
+class Cruise_ship;
+
+class Object_table {
+public:
+    Object_table() : num_removed(0), out_of_order(false) { }
+
+    // disallow copy/move construction or assignment
+    Object_table(Object_table& other)=delete;
+    Object_table(Object_table&& other)=delete;
+    Object_table& operator=(Object_table& rhs)=delete;
+    Object_table& operator=(Object_table&& rhs)=delete;
+
+    // add an object, awake
+    void insert(Sim_object* object_ptr);
+    // remove an object; no error if it is not present
+    void remove(const Sim_object* object_ptr);
+    // remove every object
+    void clear();
+    // wake an object; no effect if it is not present
+    void wake(const Sim_object* object_ptr);
+
+    // update every object, in name order
+    void update_all();
+    // update every awake object, in name order, and put to sleep those that are
+    // idle afterwards
+    void update_awake();
+    // the least number of ticks any awake object can skip, at most max_ticks
+    int ticks_until_next_event(int max_ticks) const;
+    // have every awake object skip num_ticks
+    void skip_ticks(int num_ticks);
+
+private:
+    enum class Kind_e : unsigned char { ISLAND, TANKER, CRUISER, CRUISE_SHIP, OTHER };
+    struct Place {
+        Kind_e kind;
+        int index;
+    };
+    template<typename T>
+    struct Entry {
+        T* object_ptr;      // nullptr once the object is removed
+        bool awake;
+    };
+
+    std::vector<Entry<Island>> islands;
+    std::vector<Entry<Tanker>> tankers;
+    std::vector<Entry<Cruiser>> cruisers;
+    std::vector<Entry<Cruise_ship>> cruise_ships;
+    std::vector<Entry<Sim_object>> other_objects;
+    // where each object is, in name order unless out_of_order
+    std::vector<Place> name_order;
+    Id_map<Place> places;
+    int num_removed;        // entries marked as gone since the last tidy
+    bool out_of_order;      // objects added since the last tidy
+
+    // call f with the Entry at place
+    template<typename F>
+    void with_entry(Place place, F f);
+    // call f with every Entry of table, kind by kind
+    template<typename Table, typename F>
+    static void for_each_entry(Table& table, F f);
+    // compact the arrays and put them in name order, if that is due
+    void tidy();
+};
+
+#endif
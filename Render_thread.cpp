@@ -0,0 +1,152 @@
+#include "Render_thread.h"
+#include "View.h"
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+using std::cout;
+using std::lock_guard;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::move;
+using std::mutex;
+using std::ostringstream;
+using std::streamsize;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+// route cout through the Render_thread and start the thread
+Render_thread::Render_thread() : next_to_publish(0), next_to_draw(0), console(cout.rdbuf()),
+    console_streambuf(*this), newest_unwritten(-1), stopping(false) {
+    for(Frame_buffer& buffer : buffers) {
+        buffer.full.store(false);
+    }
+    cout.rdbuf(&console_streambuf);
+    render_thread = thread(&Render_thread::render_loop, this);
+}
+
+// draw the frames still waiting, give cout back its streambuf, and stop the thread
+Render_thread::~Render_thread() {
+    {
+        lock_guard<mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake_cv.notify_one();
+    render_thread.join();
+    if(cout.rdbuf() == &console_streambuf) {
+        cout.rdbuf(console);
+    }
+    console->pubsync();
+}
+
+// true if cout is going through the Render_thread, rather than redirected
+bool Render_thread::is_routing_cout() const {
+    return cout.rdbuf() == &console_streambuf;
+}
+
+// Hand over frames to be drawn in order, formatted like cout is now. Returns
+// at once unless both buffers are still in use.
+void Render_thread::publish(vector<unique_ptr<View_frame>> frames) {
+    Frame_buffer& buffer = buffers[next_to_publish];
+    while(buffer.full.load(memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    buffer.frames = move(frames);
+    buffer.flags = cout.flags();
+    buffer.precision = cout.precision();
+    {
+        lock_guard<mutex> lock(console_mutex);
+        newest_unwritten = next_to_publish;
+    }
+    buffer.full.store(true, memory_order_release);
+    next_to_publish = 1 - next_to_publish;
+    {
+        lock_guard<mutex> lock(wake_mutex);
+    }
+    wake_cv.notify_one();
+}
+
+// write text to the console, or hold it back behind unwritten frames
+void Render_thread::write_text(const char* text, streamsize count) {
+    lock_guard<mutex> lock(console_mutex);
+    if(newest_unwritten >= 0) {
+        buffers[newest_unwritten].held_text.append(text, static_cast<size_t>(count));
+    } else {
+        console->sputn(text, count);
+    }
+}
+
+// flush the console unless text is being held back
+int Render_thread::sync_console() {
+    lock_guard<mutex> lock(console_mutex);
+    return newest_unwritten >= 0 ? 0 : console->pubsync();
+}
+
+// wait for frames, draw them, repeat until told to stop and none are left
+void Render_thread::render_loop() {
+    while(true) {
+        Frame_buffer& buffer = buffers[next_to_draw];
+        if(!buffer.full.load(memory_order_acquire)) {
+            unique_lock<mutex> lock(wake_mutex);
+            wake_cv.wait(lock, [this, &buffer] {
+                return buffer.full.load(memory_order_acquire) || stopping.load(); });
+            if(!buffer.full.load(memory_order_acquire)) {
+                return;
+            }
+        }
+        draw_buffer(next_to_draw);
+        next_to_draw = 1 - next_to_draw;
+    }
+}
+
+// write out a buffer's frames and then the text held back behind them
+/* The frames can go out without holding console_mutex, since nothing else is
+written to the console while they are unwritten. */
+void Render_thread::draw_buffer(int buffer_index) {
+    Frame_buffer& buffer = buffers[buffer_index];
+    ostringstream frame_stream;
+    frame_stream.flags(buffer.flags);
+    frame_stream.precision(buffer.precision);
+    for(const auto& frame_ptr : buffer.frames) {
+        frame_ptr->draw(frame_stream);
+    }
+    buffer.frames.clear();
+    string frame_text = frame_stream.str();
+    console->sputn(frame_text.data(), static_cast<streamsize>(frame_text.size()));
+    {
+        lock_guard<mutex> lock(console_mutex);
+        console->sputn(buffer.held_text.data(), static_cast<streamsize>(buffer.held_text.size()));
+        buffer.held_text.clear();
+        if(newest_unwritten == buffer_index) {
+            newest_unwritten = -1;
+        }
+        console->pubsync();
+    }
+    buffer.full.store(false, memory_order_release);
+}
+
+Render_thread::Console_streambuf::int_type Render_thread::Console_streambuf::overflow(int_type c) {
+    if(!traits_type::eq_int_type(c, traits_type::eof())) {
+        char ch = traits_type::to_char_type(c);
+        renderer.write_text(&ch, 1);
+    }
+    return traits_type::not_eof(c);
+}
+
+streamsize Render_thread::Console_streambuf::xsputn(const char* text, streamsize count) {
+    renderer.write_text(text, count);
+    return count;
+}
+
+int Render_thread::Console_streambuf::sync() {
+    return renderer.sync_console();
+}
@@ -0,0 +1,98 @@
+/* Render_thread class
+A Render_thread draws the Views on a thread of its own, so that the simulation does
+not wait while a map is formatted and written out. The Model captures each View's
+frame (see View.h), a copy of what the View shows that needs nothing else to be
+drawn, and publishes the frames of one show; the Render_thread draws them later.
+
+Published frames go into one of two buffers, used in turn: while the Render_thread
+draws from one, the next show fills the other. A buffer is handed over by an atomic
+store of its full flag rather than under a lock, and publish only has to wait when
+both buffers are still in use. A lock is taken briefly to wake the Render_thread if
+it is idle.
+
+The output must come out in the same order as if the frames had been drawn on the
+spot. For that the Render_thread takes over cout's streambuf for as long as it
+exists: while a frame is waiting or being drawn, text written to cout is held back
+with that frame and written out right after it.
+*/
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+#include <atomic>
+#include <condition_variable>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+class View_frame;
+
+class Render_thread {
+public:
+    // route cout through the Render_thread and start the thread
+    Render_thread();
+    // draw the frames still waiting, give cout back its streambuf, and stop the thread
+    ~Render_thread();
+
+    // disallow copy/move construction or assignment
+    Render_thread(Render_thread& other)=delete;
+    Render_thread(Render_thread&& other)=delete;
+    Render_thread& operator=(Render_thread& rhs)=delete;
+    Render_thread& operator=(Render_thread&& rhs)=delete;
+
+    // true if cout is going through the Render_thread, rather than redirected
+    bool is_routing_cout() const;
+    // Hand over frames to be drawn in order, formatted like cout is now. Returns
+    // at once unless both buffers are still in use.
+    void publish(std::vector<std::unique_ptr<View_frame>> frames);
+
+private:
+    // what cout writes to while the Render_thread exists
+    class Console_streambuf : public std::streambuf {
+    public:
+        explicit Console_streambuf(Render_thread& renderer_) : renderer(renderer_) {}
+    protected:
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char* text, std::streamsize count) override;
+        int sync() override;
+    private:
+        Render_thread& renderer;
+    };
+
+    struct Frame_buffer {
+        std::vector<std::unique_ptr<View_frame>> frames;
+        std::ios::fmtflags flags;
+        std::streamsize precision;
+        // text written to cout after the frames were published; guarded by console_mutex
+        std::string held_text;
+        // set by publish, cleared once everything in the buffer is written
+        std::atomic<bool> full;
+    };
+
+    Frame_buffer buffers[2];
+    int next_to_publish;        // used only by the simulation thread
+    int next_to_draw;           // used only by the render thread
+    std::streambuf* console;    // cout's streambuf before we took it over
+    Console_streambuf console_streambuf;
+    std::mutex console_mutex;
+    // the buffer whose frames are the last published and not yet written, or -1
+    int newest_unwritten;
+    // only for letting an idle render thread sleep, not for handing over frames
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    std::atomic<bool> stopping;
+    std::thread render_thread;
+
+    // write text to the console, or hold it back behind unwritten frames
+    void write_text(const char* text, std::streamsize count);
+    // flush the console unless text is being held back
+    int sync_console();
+    // wait for frames, draw them, repeat until told to stop and none are left
+    void render_loop();
+    // write out a buffer's frames and then the text held back behind them
+    void draw_buffer(int buffer_index);
+};
+
+#endif
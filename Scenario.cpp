@@ -0,0 +1,301 @@
+#include "Scenario.h"
+#include "Ship_factory.h"
+#include "Utility.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+using std::adjacent_find;
+using std::ifstream;
+using std::ios;
+using std::isfinite;
+using std::lower_bound;
+using std::memchr;
+using std::memmove;
+using std::size_t;
+using std::sort;
+using std::strcmp;
+using std::string;
+using std::strtod;
+using std::vector;
+
+const char* const scenario_invalid_error_c = "Invalid scenario file!";
+// size of the blocks a scenario file is read in
+const size_t scenario_block_size_c = 1 << 20;
+// the most fields a line can have: "order <ship> position <x> <y> <speed>"
+const int max_fields_c = 6;
+// Powers of ten that are exact as doubles
+const double exact_powers_of_ten_c[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+    1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+using Command_e = Scenario::Order_spec::Command_e;
+
+// Convert a whole field to a finite double; return false if it is not a number
+/* A plain decimal with at most 15 significant digits has an exact integer mantissa
+and an exact power of ten for a divisor, so one division rounds it exactly as strtod
+would. Everything else - exponents, long mantissas - goes to strtod. */
+static bool parse_number(const char* field, double& value) {
+    const char* p = field;
+    bool negative = (*p == '-');
+    if(*p == '-' || *p == '+') {
+        ++p;
+    }
+    unsigned long long mantissa = 0;
+    int num_digits = 0, num_fraction_digits = 0;
+    bool seen_digit = false, seen_point = false;
+    for(;; ++p) {
+        if(*p >= '0' && *p <= '9') {
+            seen_digit = true;
+            if(seen_point) {
+                ++num_fraction_digits;
+            }
+            if(mantissa != 0 || *p != '0') {
+                mantissa = mantissa * 10 + (*p - '0');
+                ++num_digits;
+            }
+        } else if(*p == '.' && !seen_point) {
+            seen_point = true;
+        } else {
+            break;
+        }
+    }
+    if(*p == '\0' && seen_digit && num_digits <= 15 && num_fraction_digits <= 22) {
+        value = static_cast<double>(mantissa) / exact_powers_of_ten_c[num_fraction_digits];
+        if(negative) {
+            value = -value;
+        }
+        return true;
+    }
+    char* end;
+    value = strtod(field, &end);
+    return end != field && *end == '\0' && isfinite(value);
+}
+
+static double read_number(const char* field) {
+    double value;
+    if(!parse_number(field, value)) {
+        throw Error(scenario_invalid_error_c);
+    }
+    return value;
+}
+
+static double read_speed(const char* field) {
+    double speed = read_number(field);
+    if(speed < 0.) {
+        throw Error(scenario_invalid_error_c);
+    }
+    return speed;
+}
+
+static string read_name(const char* field) {
+    string name(field);
+    if(name.size() < 2) {
+        throw Error(scenario_invalid_error_c);
+    }
+    return name;
+}
+
+// Add the order described by the fields of an order line
+static void read_order(char* const* fields, int num_fields, Scenario& scenario) {
+    Scenario::Order_spec order;
+    order.ship_name = fields[1];
+    order.course = order.speed = 0.;
+    const char* command = fields[2];
+    int num_arguments = num_fields - 3;
+    char* const* arguments = fields + 3;
+    if(!strcmp(command, "course") && num_arguments == 2) {
+        order.command = Command_e::COURSE;
+        order.course = read_number(arguments[0]);
+        if(order.course < 0. || order.course >= 360.) {
+            throw Error(scenario_invalid_error_c);
+        }
+        order.speed = read_speed(arguments[1]);
+    } else if(!strcmp(command, "position") && num_arguments == 3) {
+        order.command = Command_e::POSITION;
+        order.position = Point(read_number(arguments[0]), read_number(arguments[1]));
+        order.speed = read_speed(arguments[2]);
+    } else if(!strcmp(command, "destination") && num_arguments == 2) {
+        order.command = Command_e::DESTINATION;
+        order.target_name = arguments[0];
+        order.speed = read_speed(arguments[1]);
+    } else if(!strcmp(command, "load_at") && num_arguments == 1) {
+        order.command = Command_e::LOAD_AT;
+        order.target_name = arguments[0];
+    } else if(!strcmp(command, "unload_at") && num_arguments == 1) {
+        order.command = Command_e::UNLOAD_AT;
+        order.target_name = arguments[0];
+    } else if(!strcmp(command, "dock_at") && num_arguments == 1) {
+        order.command = Command_e::DOCK_AT;
+        order.target_name = arguments[0];
+    } else if(!strcmp(command, "attack") && num_arguments == 1) {
+        order.command = Command_e::ATTACK;
+        order.target_name = arguments[0];
+    } else if(!strcmp(command, "refuel") && num_arguments == 0) {
+        order.command = Command_e::REFUEL;
+    } else if(!strcmp(command, "stop") && num_arguments == 0) {
+        order.command = Command_e::STOP;
+    } else if(!strcmp(command, "stop_attack") && num_arguments == 0) {
+        order.command = Command_e::STOP_ATTACK;
+    } else {
+        throw Error(scenario_invalid_error_c);
+    }
+    scenario.orders.push_back(order);
+}
+
+// Split one line, which must end in '\0', into fields in place and add what it describes
+static void read_line(char* line, Scenario& scenario) {
+    char* fields[max_fields_c];
+    int num_fields = 0;
+    char* p = line;
+    while(true) {
+        while(*p == ' ' || *p == '\t' || *p == '\r') {
+            ++p;
+        }
+        if(*p == '\0' || (num_fields == 0 && *p == '#')) {
+            break;
+        }
+        if(num_fields == max_fields_c) {
+            throw Error(scenario_invalid_error_c);
+        }
+        fields[num_fields++] = p;
+        while(*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r') {
+            ++p;
+        }
+        if(*p != '\0') {
+            *p++ = '\0';
+        }
+    }
+    if(num_fields == 0) {
+        return;
+    }
+    if(!strcmp(fields[0], "island") && num_fields >= 4 && num_fields <= 6) {
+        Scenario::Island_spec island{read_name(fields[1]),
+            Point(read_number(fields[2]), read_number(fields[3])), 0., 0.};
+        if(num_fields >= 5) {
+            island.fuel = read_number(fields[4]);
+        }
+        if(num_fields == 6) {
+            island.production_rate = read_number(fields[5]);
+        }
+        scenario.islands.push_back(island);
+    } else if(!strcmp(fields[0], "ship") && num_fields == 5) {
+        if(!is_ship_type(fields[2])) {
+            throw Error(scenario_invalid_error_c);
+        }
+        scenario.ships.push_back(Scenario::Ship_spec{read_name(fields[1]), fields[2],
+            Point(read_number(fields[3]), read_number(fields[4]))});
+    } else if(!strcmp(fields[0], "order") && num_fields >= 3) {
+        read_order(fields, num_fields, scenario);
+    } else {
+        throw Error(scenario_invalid_error_c);
+    }
+}
+
+// Read every complete line in buffer[0, size) and return how many characters that took
+static size_t read_lines(char* buffer, size_t size, Scenario& scenario) {
+    char* line = buffer;
+    char* limit = buffer + size;
+    while(char* newline = static_cast<char*>(memchr(line, '\n', limit - line))) {
+        *newline = '\0';
+        read_line(line, scenario);
+        line = newline + 1;
+    }
+    return line - buffer;
+}
+
+template<typename Spec>
+static bool names_less(const Spec& spec1, const Spec& spec2) {
+    return spec1.name < spec2.name;
+}
+
+template<typename Spec>
+static bool contains_name(const vector<Spec>& specs, const string& name) {
+    auto spec_it = lower_bound(specs.begin(), specs.end(), name,
+                               [](const Spec& spec, const string& key) { return spec.name < key; });
+    return spec_it != specs.end() && spec_it->name == name;
+}
+
+// Sort the Islands and Ships by name and check the names and the orders' references
+static void check_scenario(Scenario& scenario) {
+    sort(scenario.islands.begin(), scenario.islands.end(), names_less<Scenario::Island_spec>);
+    sort(scenario.ships.begin(), scenario.ships.end(), names_less<Scenario::Ship_spec>);
+    auto same_name = [](const auto& spec1, const auto& spec2) { return spec1.name == spec2.name; };
+    if(adjacent_find(scenario.islands.begin(), scenario.islands.end(), same_name) != scenario.islands.end()
+       || adjacent_find(scenario.ships.begin(), scenario.ships.end(), same_name) != scenario.ships.end()) {
+        throw Error(scenario_invalid_error_c);
+    }
+    for(const auto& island : scenario.islands) {
+        if(contains_name(scenario.ships, island.name)) {
+            throw Error(scenario_invalid_error_c);
+        }
+    }
+    for(const auto& order : scenario.orders) {
+        bool target_found = true;
+        switch(order.command) {
+            case Command_e::DESTINATION:
+            case Command_e::LOAD_AT:
+            case Command_e::UNLOAD_AT:
+            case Command_e::DOCK_AT:
+                target_found = contains_name(scenario.islands, order.target_name);
+                break;
+            case Command_e::ATTACK:
+                target_found = contains_name(scenario.ships, order.target_name);
+                break;
+            default:
+                break;
+        }
+        if(!target_found || !contains_name(scenario.ships, order.ship_name)) {
+            throw Error(scenario_invalid_error_c);
+        }
+    }
+}
+
+// Read and check a scenario file
+/* Only complete lines are read from each block; the unfinished line at the end
+is moved to the front of the buffer and the next block is read in after it. */
+Scenario read_scenario_file(const string& filename) {
+    ifstream file(filename, ios::in | ios::binary);
+    if(!file) {
+        throw Error("Could not open file!");
+    }
+    Scenario scenario;
+    // one extra character so that a last line without a newline can be ended
+    vector<char> buffer(scenario_block_size_c + 1);
+    size_t held = 0;
+    while(true) {
+        if(held == buffer.size() - 1) {
+            buffer.resize(2 * buffer.size());
+        }
+        file.read(&buffer[held], buffer.size() - 1 - held);
+        size_t num_read = static_cast<size_t>(file.gcount());
+        if(num_read == 0) {
+            break;
+        }
+        size_t size = held + num_read;
+        size_t used = read_lines(&buffer[0], size, scenario);
+        held = size - used;
+        memmove(&buffer[0], &buffer[used], held);
+    }
+    if(file.bad()) {
+        throw Error("Could not open file!");
+    }
+    if(held > 0) {
+        buffer[held] = '\0';
+        read_line(&buffer[0], scenario);
+    }
+    check_scenario(scenario);
+    return scenario;
+}
+
+// Read and check scenario text held in memory; errors as for read_scenario_file
+Scenario read_scenario_text(const string& text) {
+    Scenario scenario;
+    vector<char> buffer(text.begin(), text.end());
+    buffer.push_back('\n');
+    read_lines(&buffer[0], buffer.size(), scenario);
+    check_scenario(scenario);
+    return scenario;
+}
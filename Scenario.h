@@ -0,0 +1,69 @@
+/* Scenario reading
+A scenario is a text file describing a world to start from: its Islands, its Ships,
+and any orders the Ships should start out with. Each line is one of
+
+    island <name> <x> <y> [<fuel> [<production rate>]]
+    ship <name> <type> <x> <y>
+    order <ship name> <ship command and its arguments>
+
+where <type> is any type known to the Ship_factory and the ship command is one of
+the Controller's (course, position, destination, load_at, unload_at, dock_at,
+attack, refuel, stop, stop_attack) with the same arguments. Blank lines and lines
+starting with # are ignored. Objects may be listed in any order and orders may refer
+to objects listed after them. Names must be at least two characters long and
+different from every other name; unlike the create command, names that merely share
+their first two characters are allowed, since large scenarios could not otherwise
+be written.
+
+The file is read a block at a time and each line is split in place; numbers are
+converted with a fast path for plain decimals that gives exactly the same value as
+the standard conversion, which is used for anything else. Reading only builds a
+Scenario description; Model::load_scenario creates the objects.
+*/
+#ifndef SCENARIO_H
+#define SCENARIO_H
+#include "Geometry.h"
+#include <string>
+#include <vector>
+
+struct Scenario {
+    struct Island_spec {
+        std::string name;
+        Point position;
+        double fuel;
+        double production_rate;
+    };
+    struct Ship_spec {
+        std::string name;
+        std::string type;
+        Point position;
+    };
+    struct Order_spec {
+        enum class Command_e { COURSE, POSITION, DESTINATION, LOAD_AT, UNLOAD_AT,
+                               DOCK_AT, ATTACK, REFUEL, STOP, STOP_ATTACK };
+        std::string ship_name;
+        Command_e command;
+        // the Island or Ship named by the command, if any
+        std::string target_name;
+        // course and speed, position and speed, or speed alone
+        Point position;
+        double course;
+        double speed;
+    };
+
+    // Islands and Ships are kept sorted by name
+    std::vector<Island_spec> islands;
+    std::vector<Ship_spec> ships;
+    // orders are kept in the order given
+    std::vector<Order_spec> orders;
+};
+
+// Read and check a scenario file
+// will throw Error("Could not open file!") if the file cannot be read
+// will throw Error("Invalid scenario file!") if any line is malformed, a name is
+// used twice, or an order refers to an object that is not in the scenario
+Scenario read_scenario_file(const std::string& filename);
+// Read and check scenario text held in memory; errors as for read_scenario_file
+Scenario read_scenario_text(const std::string& text);
+
+#endif
@@ -0,0 +1,183 @@
+#include "Script_reader.h"
+#include "Utility.h"
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using std::isdigit;
+using std::isinf;
+using std::isspace;
+using std::size_t;
+using std::strtod;
+using std::string;
+
+// at most this many characters of a number are converted; cin would take more,
+// but no number a script gives is anywhere near this long
+const size_t script_number_max_length_c = 128;
+
+// map the file into memory
+Script_reader::Script_reader(const string& filename) : data(nullptr), size(0), mapped(false) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw Error("Could not open file!");
+    }
+    struct stat file_status;
+    if(fstat(fd, &file_status) < 0) {
+        ::close(fd);
+        throw Error("Could not open file!");
+    }
+    size = static_cast<size_t>(file_status.st_size);
+    if(size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapping == MAP_FAILED) {
+            ::close(fd);
+            throw Error("Could not open file!");
+        }
+        data = static_cast<const char*>(mapping);
+        mapped = true;
+        madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    position = data;
+    end = data + size;
+}
+
+// read the length characters at text, which are not copied
+Script_reader::Script_reader(const char* text, size_t length) :
+    data(text), size(length), position(text), end(text + length), mapped(false) { }
+
+Script_reader::~Script_reader() {
+    if(mapped) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+// skip white space and find the next word, which is left where it is in the
+// file; false if the file has ended
+bool Script_reader::read_word(const char*& word, size_t& length) {
+    skip_space();
+    word = position;
+    while(position != end && !isspace(static_cast<unsigned char>(*position))) {
+        ++position;
+    }
+    length = position - word;
+    return length > 0;
+}
+
+// the same, copying the word into word, which is left empty if the file has ended
+bool Script_reader::read_word(string& word) {
+    const char* word_begin;
+    size_t length;
+    bool found = read_word(word_begin, length);
+    word.assign(word_begin, length);
+    return found;
+}
+
+// skip white space and read a number as cin would; false if there is none, or
+// it is out of range
+/* cin takes an optional sign and then every digit that follows. */
+bool Script_reader::read_int(int& value) {
+    skip_space();
+    const char* scan = position;
+    bool negative = false;
+    if(scan != end && (*scan == '+' || *scan == '-')) {
+        negative = *scan == '-';
+        ++scan;
+    }
+    const char* digits = scan;
+    long long magnitude = 0;
+    bool overflowed = false;
+    for(; scan != end && isdigit(static_cast<unsigned char>(*scan)); ++scan) {
+        magnitude = magnitude * 10 + (*scan - '0');
+        if(magnitude > static_cast<long long>(INT_MAX) + 1) {
+            overflowed = true;
+            magnitude = static_cast<long long>(INT_MAX) + 1;
+        }
+    }
+    position = scan;
+    long long signed_value = negative ? -magnitude : magnitude;
+    if(scan == digits || overflowed || signed_value > INT_MAX || signed_value < INT_MIN) {
+        return false;
+    }
+    value = static_cast<int>(signed_value);
+    return true;
+}
+
+/* cin gathers an optional sign, digits with at most one decimal point, and an
+exponent marker with an optional sign and digits, as long as a digit came before it;
+what it gathered must then convert completely and not overflow. */
+bool Script_reader::read_double(double& value) {
+    skip_space();
+    const char* scan = position;
+    if(scan != end && (*scan == '+' || *scan == '-')) {
+        ++scan;
+    }
+    bool found_digit = false, found_point = false, found_exponent = false;
+    while(scan != end) {
+        char c = *scan;
+        if(isdigit(static_cast<unsigned char>(c))) {
+            found_digit = true;
+        } else if(c == '.' && !found_point && !found_exponent) {
+            found_point = true;
+        } else if((c == 'e' || c == 'E') && !found_exponent && found_digit) {
+            found_exponent = true;
+            if(scan + 1 != end && (scan[1] == '+' || scan[1] == '-')) {
+                ++scan;
+            }
+        } else {
+            break;
+        }
+        ++scan;
+    }
+    size_t length = scan - position;
+    if(length == 0 || length > script_number_max_length_c) {
+        position = scan;
+        return false;
+    }
+    // strtod needs the number to end, which it does not in the mapping
+    char number[script_number_max_length_c + 1];
+    for(size_t i = 0; i < length; ++i) {
+        number[i] = position[i];
+    }
+    number[length] = '\0';
+    position = scan;
+    char* converted_end;
+    double converted = strtod(number, &converted_end);
+    if(converted_end != number + length || isinf(converted)) {
+        return false;
+    }
+    value = converted;
+    return true;
+}
+
+// true if the next thing on the current line is a number
+bool Script_reader::number_follows_on_line() {
+    while(position != end && (*position == ' ' || *position == '\t')) {
+        ++position;
+    }
+    return position != end && (isdigit(static_cast<unsigned char>(*position)) || *position == '-' || *position == '+');
+}
+
+// skip past the end of the current line
+void Script_reader::skip_line() {
+    while(position != end && *position != '\n') {
+        ++position;
+    }
+    if(position != end) {
+        ++position;
+    }
+}
+
+void Script_reader::skip_space() {
+    while(position != end && isspace(static_cast<unsigned char>(*position))) {
+        ++position;
+    }
+}
@@ -0,0 +1,64 @@
+/* Script_reader class
+A Script_reader reads the commands of a script file for the Controller's batch mode
+(see Controller::run_script). The whole file is mapped into memory and read in
+place: words are found where they lie in the mapping rather than copied through a
+stream one character at a time, and numbers are converted straight from it.
+
+The reader splits the text the way cin's >> would, so that a script gives the same
+results as the same text typed in: words are separated by any white space, a
+number is taken from as many characters as cin would take for it, and whatever
+follows is left for the next read. Reads report failure by their return value
+rather than by throwing; the Controller decides what a failure means.
+
+A Script_reader can also read text already in memory, such as a line sent to the
+Command_server; the text is read where it is and must outlive the reader.
+*/
+#ifndef SCRIPT_READER_H
+#define SCRIPT_READER_H
+#include <cstddef>
+#include <string>
+
+class Script_reader {
+public:
+    // map the file into memory
+    // will throw Error("Could not open file!") if the file cannot be read
+    explicit Script_reader(const std::string& filename);
+    // read the length characters at text, which are not copied
+    Script_reader(const char* text, std::size_t length);
+    ~Script_reader();
+
+    // disallow copy/move construction or assignment
+    Script_reader(Script_reader& other)=delete;
+    Script_reader(Script_reader&& other)=delete;
+    Script_reader& operator=(Script_reader& rhs)=delete;
+    Script_reader& operator=(Script_reader&& rhs)=delete;
+
+    // skip white space and find the next word, which is left where it is in the
+    // file; false if the file has ended
+    bool read_word(const char*& word, std::size_t& length);
+    // the same, copying the word into word, which is left empty if the file has ended
+    bool read_word(std::string& word);
+    // skip white space and read a number as cin would; false if there is none, or
+    // it is out of range
+    bool read_int(int& value);
+    bool read_double(double& value);
+    // true if the next thing on the current line is a number
+    bool number_follows_on_line();
+    // skip past the end of the current line
+    void skip_line();
+
+    // where the next read starts
+    const char* get_position() const
+        {return position;}
+
+private:
+    const char* data;
+    std::size_t size;
+    const char* position;
+    const char* end;
+    bool mapped;        // data is a mapping of the file, to be unmapped
+
+    void skip_space();
+};
+
+#endif
@@ -1,12 +1,18 @@
 #include "Ship.h"
 #include "Island.h"
+#include "Kinematics_store.h"
+#include "Snapshot.h"
+#include "Telemetry.h"
 #include "Model.h"
+#include "Navigation.h"
 #include "Utility.h"
+#include "Event_log.h"
 #include <memory>
 #include <iostream>
 #include <iomanip>
 using std::cout;
 using std::endl;
+using std::ostream;
 using std::string;
 using std::shared_ptr;
 using std::setprecision;
@@ -18,10 +24,22 @@ const char* const ship_attack_error_c = "Cannot attack!";
 // initialize, then output constructor message
 Ship::Ship(const string& name_, Point position_, double fuel_capacity_,
     double maximum_speed_, double fuel_consumption_, int resistance_) :
-    Sim_object(name_), fuel(fuel_capacity_), fuel_consumption(fuel_consumption_),
+    Sim_object(name_),
+    kinematics_handle(Kinematics_store::get_instance().add(position_, fuel_capacity_, fuel_consumption_)),
+    handle(Ship_handle_table::get_instance().acquire(this)),
     fuel_capacity(fuel_capacity_), maximum_speed(maximum_speed_),
-    resistance(resistance_), ship_state(Ship_State_e::STOPPED), docked_island(nullptr),
-    track_base(position_) { }
+    resistance(resistance_), ship_state(Ship_State_e::STOPPED), docked_island(nullptr) { }
+
+// give our slots back to the Kinematics_store and the Ship_handle_table
+Ship::~Ship() {
+    Kinematics_store::get_instance().remove(kinematics_handle);
+    Ship_handle_table::get_instance().release(handle);
+}
+
+// return the current position
+Point Ship::get_location() const {
+    return Kinematics_store::get_instance().get_position(kinematics_handle);
+}
 
 // Return true if ship can move (it is not dead in the water or in the process or sinking);
 bool Ship::can_move() const {
@@ -52,72 +70,149 @@ bool Ship::can_dock(shared_ptr<Island> island_ptr) const {
 }
 
 
+// true if stopped, docked, or dead in the water
+bool Ship::is_idle() const {
+    return ship_state == Ship_State_e::STOPPED || ship_state == Ship_State_e::DOCKED ||
+           ship_state == Ship_State_e::DEAD_IN_THE_WATER || ship_state == Ship_State_e::SUNK;
+}
+
+// a moving Ship can skip ahead until shortly before it arrives or runs out of fuel
+int Ship::ticks_until_event() const {
+    if(is_moving()) {
+        return Kinematics_store::get_instance().ticks_of_plain_movement(kinematics_handle);
+    }
+    return Sim_object::ticks_until_event();
+}
+
+void Ship::skip_ticks(int num_ticks) {
+    if(is_moving()) {
+        Kinematics_store::get_instance().advance(kinematics_handle, num_ticks);
+        broadcast_current_state();
+    }
+}
+
+/*** Snapshots ***/
+// write all of the Ship's state; derived classes add their own after the Ship's
+void Ship::save_state(Snapshot_writer& writer) const {
+    const Kinematics_store& kinematics = Kinematics_store::get_instance();
+    Point position = kinematics.get_position(kinematics_handle);
+    Point destination = kinematics.get_destination(kinematics_handle);
+    writer.write_double(position.x);
+    writer.write_double(position.y);
+    writer.write_double(kinematics.get_course(kinematics_handle));
+    writer.write_double(kinematics.get_speed(kinematics_handle));
+    writer.write_double(kinematics.get_fuel(kinematics_handle));
+    writer.write_double(destination.x);
+    writer.write_double(destination.y);
+    writer.write_int(resistance);
+    writer.write_byte(static_cast<unsigned char>(ship_state));
+    writer.write_island_ref(docked_island);
+}
+
+// replace all of the Ship's state with what save_state wrote
+void Ship::load_state(Snapshot_reader& reader) {
+    Kinematics_store& kinematics = Kinematics_store::get_instance();
+    double x = reader.read_double();
+    double y = reader.read_double();
+    kinematics.set_position(kinematics_handle, Point(x, y));
+    kinematics.set_course(kinematics_handle, reader.read_double());
+    kinematics.set_speed(kinematics_handle, reader.read_double());
+    kinematics.set_fuel(kinematics_handle, reader.read_double());
+    double destination_x = reader.read_double();
+    double destination_y = reader.read_double();
+    kinematics.set_destination(kinematics_handle, Point(destination_x, destination_y));
+    resistance = reader.read_int();
+    set_ship_state(static_cast<Ship_State_e>(reader.read_choice(static_cast<int>(Ship_State_e::SUNK) + 1)));
+    docked_island = reader.read_island_ref();
+}
+
+// fill in the Ship's state as the telemetry records it; derived classes add their own
+void Ship::report_telemetry(Telemetry_record& record) const {
+    const Kinematics_store& kinematics = Kinematics_store::get_instance();
+    record.fields = Telemetry_record::LOCATION | Telemetry_record::COURSE | Telemetry_record::SPEED
+        | Telemetry_record::FUEL | Telemetry_record::SHIP_STATE | Telemetry_record::RESISTANCE;
+    record.location = kinematics.get_position(kinematics_handle);
+    record.course = kinematics.get_course(kinematics_handle);
+    record.speed = kinematics.get_speed(kinematics_handle);
+    record.fuel = kinematics.get_fuel(kinematics_handle);
+    record.ship_state = static_cast<int>(ship_state);
+    record.resistance = resistance;
+}
+
 // Broadcast all state to Views
 void Ship::broadcast_current_state() {
-    Model::get_instance().notify_location(get_name(), get_location());
-    Model::get_instance().notify_fuel(get_name(), fuel);
-    Model::get_instance().notify_course_and_speed(get_name(), track_base.get_course(), track_base.get_speed());
+    Model::get_instance().notify_location(get_id(), get_location());
+    Model::get_instance().notify_fuel(get_id(), get_fuel());
+    Model::get_instance().notify_course_and_speed(get_id(), get_course_speed().course, get_course_speed().speed);
 }
 
 // Broadcast current location to Views
 void Ship::broadcast_current_location() {
-    Model::get_instance().notify_location(get_name(), get_location());
+    Model::get_instance().notify_location(get_id(), get_location());
 }
 
 // Broadcast current fuel to Views
 void Ship::broadcast_current_fuel() {
-    Model::get_instance().notify_fuel(get_name(), fuel);
+    Model::get_instance().notify_fuel(get_id(), get_fuel());
 }
 
 // Broadcast current course and speed to Views
 void Ship::broadcast_current_course_and_speed() {
-    Model::get_instance().notify_course_and_speed(get_name(), track_base.get_course(), track_base.get_speed());
+    Model::get_instance().notify_course_and_speed(get_id(), get_course_speed().course, get_course_speed().speed);
 }
 
 /*** Interface to derived classes ***/
 // Update the state of the Ship
 void Ship::update() {
-    cout << get_name();
-    if(is_afloat()) {
+    // the report is of the state before moving, which may end the movement
+    bool moving = is_afloat() && (ship_state == Ship_State_e::MOVING_ON_COURSE ||
+                                  ship_state == Ship_State_e::MOVING_TO_POSITION);
+    if(moving) {
+        calculate_movement();
+        broadcast_current_state(); // all state must be updated
+    }
+    ostream* log = log_event(Event_category_e::MOVEMENT, Event_level_e::DETAIL);
+    if(!log) {
+        return;
+    }
+    *log << get_name();
+    if(!is_afloat()) {
+        *log << " sunk";
+    } else if(moving) {
+        *log << " now at " << get_location();
+    } else {
         switch(ship_state) {
-            case Ship_State_e::MOVING_ON_COURSE: // Drop through
-            case Ship_State_e::MOVING_TO_POSITION:
-                calculate_movement();
-                cout << " now at " << get_location();
-                broadcast_current_state(); // all state must be updated
-                break;
             case Ship_State_e::STOPPED:
-                cout << " stopped at " << track_base.get_position();
+                *log << " stopped at " << get_location();
                 break;
             case Ship_State_e::DOCKED:
-                cout << " docked at " << get_docked_Island()->get_name();
+                *log << " docked at " << get_docked_Island()->get_name();
                 break;
             case Ship_State_e::DEAD_IN_THE_WATER:
-                cout << " dead in the water at " << track_base.get_position();
+                *log << " dead in the water at " << get_location();
                 break;
             default:
-                cout << default_switch_error_c << endl;
+                *log << default_switch_error_c << '\n';
                 break;
         };
-    } else {
-        cout << " sunk";
     }
-    cout << endl;
+    *log << '\n';
 }
 
 // output a description of current state to cout
 void Ship::describe() const {
-    cout << get_name() << " at " << track_base.get_position();
+    cout << get_name() << " at " << get_location();
     if(!is_afloat()) {
         cout << " sunk";
     } else {
-        cout << ", fuel: " << fuel << " tons, resistance: " << resistance << endl;
+        cout << ", fuel: " << get_fuel() << " tons, resistance: " << resistance << endl;
         switch(ship_state) {
             case Ship_State_e::MOVING_TO_POSITION:
-                cout << "Moving to " << destination <<  " on " << track_base.get_course_speed();
+                cout << "Moving to " << Kinematics_store::get_instance().get_destination(kinematics_handle)
+                    <<  " on " << get_course_speed();
                 break;
             case Ship_State_e::MOVING_ON_COURSE:
-                cout << "Moving on " << track_base.get_course_speed();
+                cout << "Moving on " << get_course_speed();
                 break;
             case Ship_State_e::DOCKED:
                 cout << "Docked at " << get_docked_Island()->get_name();
@@ -151,15 +246,17 @@ void Ship::set_destination_position_and_speed(Point destination_position, double
     if(is_docked()) {
         docked_island = nullptr;
     }
-    destination = destination_position;
-    Compass_vector compass_vec(get_location(), destination);
+    Kinematics_store& kinematics = Kinematics_store::get_instance();
+    kinematics.set_destination(kinematics_handle, destination_position);
+    Compass_vector compass_vec(get_location(), destination_position);
     
-    track_base.set_speed(speed);
-    track_base.set_course(compass_vec.direction);
-    ship_state = Ship_State_e::MOVING_TO_POSITION;
+    kinematics.set_speed(kinematics_handle, speed);
+    kinematics.set_course(kinematics_handle, compass_vec.direction);
+    set_ship_state(Ship_State_e::MOVING_TO_POSITION);
     
     broadcast_current_course_and_speed();
-    cout << get_name() << " will sail on " << track_base.get_course_speed() << " to " << destination << endl;
+    if(ostream* log = log_event(Event_category_e::ORDERS, Event_level_e::NOTICE))
+        *log << get_name() << " will sail on " << get_course_speed() << " to " << destination_position << '\n';
 }
 
 // Start moving on a course and speed
@@ -175,12 +272,13 @@ void Ship::set_course_and_speed(double course, double speed) {
     if(is_docked()) {
         docked_island = nullptr;
     }
-    track_base.set_course(course);
-    track_base.set_speed(speed);
-    ship_state = Ship_State_e::MOVING_ON_COURSE;
+    Kinematics_store::get_instance().set_course(kinematics_handle, course);
+    Kinematics_store::get_instance().set_speed(kinematics_handle, speed);
+    set_ship_state(Ship_State_e::MOVING_ON_COURSE);
     
     broadcast_current_course_and_speed();
-    cout << get_name() << " will sail on " << track_base.get_course_speed() << endl;
+    if(ostream* log = log_event(Event_category_e::ORDERS, Event_level_e::NOTICE))
+        *log << get_name() << " will sail on " << get_course_speed() << '\n';
 }
 
 // Stop moving
@@ -189,10 +287,11 @@ void Ship::stop() {
     if(!can_move()) {
         throw Error(ship_move_error_c);
     }
-    track_base.set_speed(0);
-    ship_state = Ship_State_e::STOPPED;
+    Kinematics_store::get_instance().set_speed(kinematics_handle, 0);
+    set_ship_state(Ship_State_e::STOPPED);
     broadcast_current_course_and_speed();
-    cout << get_name() << " stopping at " << get_location() << endl;
+    if(ostream* log = log_event(Event_category_e::ORDERS, Event_level_e::NOTICE))
+        *log << get_name() << " stopping at " << get_location() << '\n';
 }
 
 // dock at an Island - set our position = Island's position, go into Docked state
@@ -202,26 +301,31 @@ void Ship::dock(shared_ptr<Island> island_ptr) {
        cartesian_distance(get_location(), island_ptr->get_location()) > 0.1) {
         throw Error("Can't dock!");
     }
-    track_base.set_position(island_ptr->get_location());
+    Kinematics_store::get_instance().set_position(kinematics_handle, island_ptr->get_location());
     docked_island = island_ptr;
     
     broadcast_current_location();
-    ship_state = Ship_State_e::DOCKED;
-    cout << get_name() << " docked at " << island_ptr->get_name() << endl;
+    set_ship_state(Ship_State_e::DOCKED);
+    if(ostream* log = log_event(Event_category_e::MOVEMENT, Event_level_e::NOTICE))
+        *log << get_name() << " docked at " << island_ptr->get_name() << '\n';
 }
 
 // Refuel - must already be docked at an island; fill takes as much as possible
 // may throw Error("Must be docked!");
 void Ship::refuel() {
     if(is_docked()) {
+        Kinematics_store& kinematics = Kinematics_store::get_instance();
+        double fuel = kinematics.get_fuel(kinematics_handle);
         double required_fuel = fuel_capacity - fuel;
         if( required_fuel < .005 ) {
             fuel = fuel_capacity;
         } else {
             shared_ptr<Island> island = get_docked_Island();
             fuel += island->provide_fuel(required_fuel);
-            cout << get_name() << " now has " << fuel << " tons of fuel" << endl;
+            if(ostream* log = log_event(Event_category_e::FUEL, Event_level_e::NOTICE))
+                *log << get_name() << " now has " << fuel << " tons of fuel" << '\n';
         }
+        kinematics.set_fuel(kinematics_handle, fuel);
         broadcast_current_fuel();
     } else {
         throw Error("Must be docked!");
@@ -251,15 +355,19 @@ void Ship::stop_attack() {
 }
 
 // interactions with other objects
-// receive a hit from an attacker
-void Ship::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr) {
+// receive a hit; the Ship sinks if its resistance drops below 0
+// A Ship that is hit is woken, like every object whose state another object changes.
+void Ship::receive_hit(int hit_force) {
+    Model::get_instance().wake(shared_from_this());
     resistance -= hit_force;
-    cout << get_name() << " hit with " << hit_force << ", resistance now " << resistance << endl;
+    if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::NOTICE))
+        *log << get_name() << " hit with " << hit_force << ", resistance now " << resistance << '\n';
     if(resistance < 0) {
-        ship_state = Ship_State_e::SUNK;
-        track_base.set_speed(0.);
-        cout << get_name() << " sunk" << endl;
-        Model::get_instance().notify_gone(get_name());
+        set_ship_state(Ship_State_e::SUNK);
+        Kinematics_store::get_instance().set_speed(kinematics_handle, 0.);
+        if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::NOTICE))
+            *log << get_name() << " sunk" << '\n';
+        Model::get_instance().notify_gone(get_id());
         Model::get_instance().remove_ship(shared_from_this());
     }
 }
@@ -280,61 +388,52 @@ Calculate the new position of a ship based on how it is moving, its speed, and
 fuel state. This function should be called only if the state is
 MOVING_TO_POSITION or MOVING_ON_COURSE.
 
-Track_base has an update_position(double time) function that computes the new position
-of an object after the specified time has elapsed. If the Ship is going to move
-for a full time unit (one hour), then it will get go the "full step" distance,
-so update_position would be called with time = 1.0. If we can move less than that,
-e.g. due to not enough fuel, update position  will be called with the corresponding
-time less than 1.0.
+If the Ship is going to move for a full time unit (one hour), then it will go the
+"full step" distance, speed * 1.0. If it can move less than that, e.g. due to not
+enough fuel, it moves for the corresponding time less than 1.0. If it is moving to
+a destination within the distance possible, it stops there. If it used up its fuel
+it is dead in the water.
 
-For clarity in specifying the computation, this code assumes the specified private variable names, 
-but you may change the variable names or state names if you wish (e.g. movement_state).
+The arithmetic is done by the Kinematics_store, which normally has already computed
+this tick's result for every moving Ship in one batch before the updates start.
 */
 void Ship::calculate_movement()
 {
-	// Compute values for how much we need to move, and how much we can, and how long we can,
-	// given the fuel state, then decide what to do.
-	double time = 1.0;	// "full step" time
-	// get the distance to destination
-	double destination_distance = cartesian_distance(get_location(), destination);
-	// get full step distance we can move on this time step
-	double full_distance = track_base.get_speed() * time;
-	// get fuel required for full step distance
-	double full_fuel_required = full_distance * fuel_consumption;	// tons = nm * tons/nm
-	// how far and how long can we sail in this time period based on the fuel state?
-	double distance_possible, time_possible;
-	if(full_fuel_required <= fuel) {
-		distance_possible = full_distance;
-		time_possible = time;
-		}
-	else {
-		distance_possible = fuel / fuel_consumption;	// nm = tons / tons/nm
-		time_possible = (distance_possible / full_distance) * time;
-		}
-	
-	// are we are moving to a destination, and is the destination within the distance possible?
-    if(ship_state == Ship_State_e::MOVING_TO_POSITION && destination_distance <= distance_possible) {
-		// yes, make our new position the destination
-		track_base.set_position(destination);
-		// we travel the destination distance, using that much fuel
-		double fuel_required = destination_distance * fuel_consumption;
-		fuel -= fuel_required;
-		track_base.set_speed(0.);
-        ship_state = Ship_State_e::STOPPED;
-		}
-	else {
-		// go as far as we can, stay in the same movement state
-		// simply move for the amount of time possible
-		track_base.update_position(time_possible);
-		// have we used up our fuel?
-		if(full_fuel_required >= fuel) {
-			fuel = 0.0;
-			track_base.set_speed(0.);
-            ship_state = Ship_State_e::DEAD_IN_THE_WATER;
-			}
-		else {
-			fuel -= full_fuel_required;
-			}
-		}
+	switch(Kinematics_store::get_instance().apply_movement(kinematics_handle)) {
+		case Kinematics_store::Outcome_e::ARRIVED:
+			set_ship_state(Ship_State_e::STOPPED);
+			break;
+		case Kinematics_store::Outcome_e::OUT_OF_FUEL:
+			set_ship_state(Ship_State_e::DEAD_IN_THE_WATER);
+			break;
+		default: // moved, and stay in the same movement state
+			break;
+	}
+}
+
+// set ship_state and tell the Kinematics_store how we are moving
+void Ship::set_ship_state(Ship_State_e ship_state_) {
+    ship_state = ship_state_;
+    Kinematics_store::Motion_e motion;
+    switch(ship_state) {
+        case Ship_State_e::MOVING_ON_COURSE:
+            motion = Kinematics_store::Motion_e::ON_COURSE;
+            break;
+        case Ship_State_e::MOVING_TO_POSITION:
+            motion = Kinematics_store::Motion_e::TO_POSITION;
+            break;
+        default:
+            motion = Kinematics_store::Motion_e::STILL;
+            break;
+    }
+    Kinematics_store::get_instance().set_motion(kinematics_handle, motion);
+}
+
+// Readers for the state kept in the Kinematics_store
+double Ship::get_fuel() const {
+    return Kinematics_store::get_instance().get_fuel(kinematics_handle);
 }
 
+Course_speed Ship::get_course_speed() const {
+    return Kinematics_store::get_instance().get_course_speed(kinematics_handle);
+}
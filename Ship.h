@@ -3,8 +3,9 @@
 The initial amount of fuel is equal to the supplied fuel capacity - a full fuel tank.
 A Ship can be commanded to move to either a position or follow a course, or stop,
 dock at or refuel at an Island. It consumes fuel while moving, and becomes immobile
-if it runs out of fuel. It inherits the Sim_object interface to the rest of the system,
-and the Track_base class provides the basic movement functionality, with the unit of time
+if it runs out of fuel. It inherits the Sim_object interface to the rest of the system.
+Its position, course, speed, fuel and destination are kept in its slot of the
+Kinematics_store, which provides the basic movement functionality, with the unit of time
 corresponding to 1.0 for one "tick" - an hour of simulated time.
 
 The update function updates the position and/or state of the ship.
@@ -16,10 +17,15 @@ functions are implemented in this class to throw an Error exception.
 #ifndef SHIP_H
 #define SHIP_H
 #include "Sim_object.h"
-#include "Track_base.h"
+#include "Geometry.h"
+#include "Ship_handle_table.h"
 #include <memory>
 
 class Island;
+struct Course_speed;
+class Snapshot_writer;
+class Snapshot_reader;
+struct Telemetry_record;
 class Tanker;
 class Cruise_ship;
 class Cruiser;
@@ -31,10 +37,16 @@ public:
     Ship(Ship&& other)=delete;
     Ship& operator=(Ship& rhs)=delete;
     Ship& operator=(Ship&& rhs)=delete;
+    // give our slots back to the Kinematics_store and the Ship_handle_table
+    ~Ship();
 	
 	/*** Readers ***/
 	// return the current position
-	Point get_location() const override {return track_base.get_position();}
+	Point get_location() const override;
+
+	// return the current fuel, and course and speed
+	double get_fuel() const;
+	Course_speed get_course_speed() const;
 
 	// Return true if ship can move (it is not dead in the water or in the process or sinking);
 	bool can_move() const;
@@ -51,10 +63,33 @@ public:
 	// Return true if the ship is Stopped and the distance to the supplied island
 	// is less than or equal to 0.1 nm
     bool can_dock(std::shared_ptr<Island> island_ptr) const;
+
+	// the type name the Ship_factory creates this kind of Ship from
+	virtual const char* get_type_name() const = 0;
+
+	// a handle to this Ship, which goes stale once the Ship has sunk
+	Ship_handle get_handle() const
+		{return handle;}
 	
 	/*** Interface to derived classes ***/
 	// Update the state of the Ship
 	void update() override;
+	// true if stopped, docked, or dead in the water
+	bool is_idle() const override;
+	// a moving Ship can skip ahead until shortly before it arrives or runs out of fuel
+	int ticks_until_event() const override;
+	void skip_ticks(int num_ticks) override;
+
+	/*** Snapshots ***/
+	// write all of the Ship's state; derived classes add their own after the Ship's
+	virtual void save_state(Snapshot_writer& writer) const;
+	// replace all of the Ship's state with what save_state wrote
+	// may throw Error("Invalid snapshot file!")
+	virtual void load_state(Snapshot_reader& reader);
+
+	/*** Telemetry ***/
+	// fill in the Ship's state as the telemetry records it; derived classes add their own
+	virtual void report_telemetry(Telemetry_record& record) const;
 	// output a description of current state to cout
 	void describe() const override;
 
@@ -98,9 +133,11 @@ public:
     // will always throw Error("Cannot attack!");
 	virtual void stop_attack();
 
-	// interactions with other objects
-	// receive a hit from an attacker
-    virtual void receive_hit(int hit_force, std::shared_ptr<Ship> attacker_ptr);
+	// interactions with other objects, carried out by the Model's Combat_queue
+	// receive a hit; the Ship sinks if its resistance drops below 0
+    void receive_hit(int hit_force);
+	// respond to having been hit by an attacker; nothing for this class
+    virtual void respond_to_hit(std::shared_ptr<Ship>) {}
 
     // Virtual response functions to attacks
     virtual void respond_to_attack(std::shared_ptr<Tanker> tanker_ptr) {};
@@ -120,22 +157,23 @@ protected:
     std::shared_ptr<Island> get_docked_Island() const;
 
 private:
+    // SUNK must stay last; snapshots check states against it
     enum class Ship_State_e {
         DOCKED, STOPPED, MOVING_TO_POSITION, DEAD_IN_THE_WATER,
         MOVING_ON_COURSE, SUNK
     };
 
-	double fuel;						// Current amount of fuel
-	double fuel_consumption;			// tons/nm required
+    int kinematics_handle;  // position, course, speed, fuel, destination
+    Ship_handle handle;
     double fuel_capacity;
     double maximum_speed;
     int resistance;
-	Point destination; // Current destination if any
     Ship_State_e ship_state;
     std::shared_ptr<Island> docked_island;
-    Track_base track_base;
 
 	// Updates position, fuel, and movement_state, assuming 1 time unit (1 hr)
 	void calculate_movement();
+	// set ship_state and tell the Kinematics_store how we are moving
+	void set_ship_state(Ship_State_e ship_state_);
 };
 #endif
\ No newline at end of file
@@ -1,28 +1,35 @@
 #include "Ship_factory.h"
 #include "Utility.h"
+#include "Object_pool.h"
 #include "Cruise_ship.h"
 #include "Cruiser.h"
 #include "Tanker.h"
 #include <memory>
-using std::make_shared;
+using std::allocate_shared;
 using std::string;
 using std::shared_ptr;
 
 class Ship;
 /* This is a very simple form of factory, a function; you supply the information, it creates
- the specified kind of object and returns a pointer to it. The Ship is allocated
- with new, so some other component is resposible for deleting it.
+ the specified kind of object and returns a pointer to it. The Ship and its
+ shared_ptr control block are allocated together from the pool for their size
+ (see Object_pool.h), and go back to it when the last pointer to the Ship is gone.
  */
 
 // may throw Error("Trying to create ship of unknown type!")
 shared_ptr<Ship> create_ship(const string& name, const string& type, Point initial_position) {
     if(type == "Cruiser") {
-        return make_shared<Cruiser>(name, initial_position);
+        return allocate_shared<Cruiser>(Pool_allocator<Cruiser>(), name, initial_position);
     } else if(type == "Tanker") {
-        return make_shared<Tanker>(name, initial_position);
+        return allocate_shared<Tanker>(Pool_allocator<Tanker>(), name, initial_position);
     } else if(type == "Cruise_ship") {
-        return make_shared<Cruise_ship>(name, initial_position);
+        return allocate_shared<Cruise_ship>(Pool_allocator<Cruise_ship>(), name, initial_position);
     } else {
         throw Error("Trying to create ship of unknown type!");
     }
-}
\ No newline at end of file
+}
+
+// is type one that create_ship can create?
+bool is_ship_type(const string& type) {
+    return type == "Cruiser" || type == "Tanker" || type == "Cruise_ship";
+}
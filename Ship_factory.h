@@ -1,6 +1,7 @@
 /* This is a very simple form of factory, a function; you supply the information, it creates
 the specified kind of object and returns a pointer to it. The Ship is allocated
-with new, so some other component is resposible for deleting it.
+from an object pool (see Object_pool.h) and goes back to it when the last pointer
+to it is gone.
 */
 #ifndef SHIP_FACTORY_H
 #define SHIP_FACTORY_H
@@ -12,5 +13,7 @@ class Ship;
 
 // may throw Error("Trying to create ship of unknown type!")
 std::shared_ptr<Ship> create_ship(const std::string& name, const std::string& type, Point initial_position);
+// is type one that create_ship can create?
+bool is_ship_type(const std::string& type);
 
 #endif
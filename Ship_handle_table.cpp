@@ -0,0 +1,34 @@
+#include "Ship_handle_table.h"
+#include <vector>
+
+// static method to get the instance of Ship_handle_table
+Ship_handle_table& Ship_handle_table::get_instance() {
+    static Ship_handle_table table;
+    return table;
+}
+
+// a handle to a new slot holding ship_ptr
+Ship_handle Ship_handle_table::acquire(Ship* ship_ptr) {
+    int index;
+    if(free_slots.empty()) {
+        index = static_cast<int>(slots.size());
+        slots.push_back(Slot{nullptr, 0});
+    } else {
+        index = free_slots.back();
+        free_slots.pop_back();
+    }
+    slots[index].ship_ptr = ship_ptr;
+    return Ship_handle{index, slots[index].generation};
+}
+
+// give up the slot of handle, making every handle to it stale; no effect if
+// handle is already stale
+void Ship_handle_table::release(Ship_handle handle) {
+    if(!get(handle)) {
+        return;
+    }
+    Slot& slot = slots[handle.index];
+    slot.ship_ptr = nullptr;
+    ++slot.generation;
+    free_slots.push_back(handle.index);
+}
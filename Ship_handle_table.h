@@ -0,0 +1,62 @@
+/* Ship_handle_table class
+A Ship_handle refers to a Ship much as a weak_ptr would, but checking it takes no
+atomic reference counting: it is the index of a slot in the Ship_handle_table and
+the generation the slot was in when the handle was made. Each Ship takes a slot when
+it is created and gives it up when it sinks (see Model::remove_ship) or is destroyed,
+whichever comes first. Giving up a slot bumps its generation, so every handle to the
+Ship goes stale at once and get then returns nullptr, in constant time. Slots that
+have been given up are reused.
+
+The table is not thread-safe; only the thread running the simulation may use it.
+*/
+#ifndef SHIP_HANDLE_TABLE_H
+#define SHIP_HANDLE_TABLE_H
+#include <vector>
+
+class Ship;
+
+struct Ship_handle {
+    int index;                  // -1 for no Ship
+    unsigned int generation;
+};
+
+class Ship_handle_table {
+public:
+    // static method to get the instance of Ship_handle_table
+    static Ship_handle_table& get_instance();
+
+    // disallow copy/move construction or assignment
+    Ship_handle_table(Ship_handle_table& other)=delete;
+    Ship_handle_table(Ship_handle_table&& other)=delete;
+    Ship_handle_table& operator=(Ship_handle_table& rhs)=delete;
+    Ship_handle_table& operator=(Ship_handle_table&& rhs)=delete;
+
+    // a handle to a new slot holding ship_ptr
+    Ship_handle acquire(Ship* ship_ptr);
+    // give up the slot of handle, making every handle to it stale; no effect if
+    // handle is already stale
+    void release(Ship_handle handle);
+    // the Ship handle refers to, or nullptr if it is stale or refers to no Ship
+    Ship* get(Ship_handle handle) const
+    {
+        if(handle.index < 0) {
+            return nullptr;
+        }
+        const Slot& slot = slots[handle.index];
+        return slot.generation == handle.generation ? slot.ship_ptr : nullptr;
+    }
+
+private:
+    Ship_handle_table() { }
+    ~Ship_handle_table() { }
+
+    struct Slot {
+        Ship* ship_ptr;
+        unsigned int generation;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<int> free_slots;
+};
+
+#endif
@@ -1,8 +1,10 @@
 #include "Sim_object.h"
+#include "Name_registry.h"
 #include <iostream>
 using std::cout;
 using std::endl;
 using std::string;
 
 // *** define the constructor in Sim_object.cpp to output the supplied message
-Sim_object::Sim_object(const string& name_) : name(name_) { }
\ No newline at end of file
+Sim_object::Sim_object(const string& name_) : name(name_),
+    id(Name_registry::get_instance().intern(name_)) { }
\ No newline at end of file
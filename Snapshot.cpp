@@ -0,0 +1,208 @@
+#include "Snapshot.h"
+#include "Island.h"
+#include "Name_registry.h"
+#include "Ship.h"
+#include "Utility.h"
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using std::ios;
+using std::memcmp;
+using std::memcpy;
+using std::shared_ptr;
+using std::size_t;
+using std::string;
+
+const char snapshot_magic_c[8] = {'S', 'H', 'I', 'P', 'S', 'N', 'A', 'P'};
+const int snapshot_version_c = 1;
+const char* const snapshot_invalid_error_c = "Invalid snapshot file!";
+
+// ***** Snapshot_writer Implementation ***** //
+
+// create the file and write the header
+Snapshot_writer::Snapshot_writer(const string& filename) :
+    file(filename, ios::out | ios::binary | ios::trunc) {
+    if(!file) {
+        throw Error("Could not open file!");
+    }
+    write_raw(snapshot_magic_c, sizeof(snapshot_magic_c));
+    write_int(snapshot_version_c);
+}
+
+void Snapshot_writer::write_count(size_t count) {
+    unsigned long long value = count;
+    write_raw(&value, sizeof(value));
+}
+
+void Snapshot_writer::write_string(const string& value) {
+    write_count(value.size());
+    write_raw(value.data(), value.size());
+}
+
+// an empty name stands for nullptr; no object has an empty name
+void Snapshot_writer::write_island_ref(const shared_ptr<Island>& island_ptr) {
+    write_string(island_ptr ? island_ptr->get_name() : string());
+}
+
+void Snapshot_writer::write_ship_ref(const Ship* ship_ptr) {
+    write_string(ship_ptr ? ship_ptr->get_name() : string());
+}
+
+// finish the file
+void Snapshot_writer::close() {
+    file.close();
+    if(file.fail()) {
+        throw Error("Could not write file!");
+    }
+}
+
+// ***** Snapshot_reader Implementation ***** //
+
+// map the file into memory and check the header
+Snapshot_reader::Snapshot_reader(const string& filename) : data(nullptr), size(0), offset(0) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw Error("Could not open file!");
+    }
+    struct stat file_status;
+    if(fstat(fd, &file_status) < 0) {
+        ::close(fd);
+        throw Error("Could not open file!");
+    }
+    size = static_cast<size_t>(file_status.st_size);
+    if(size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapping == MAP_FAILED) {
+            ::close(fd);
+            throw Error("Could not open file!");
+        }
+        data = static_cast<const char*>(mapping);
+        madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    char magic[sizeof(snapshot_magic_c)];
+    try {
+        read_raw(magic, sizeof(magic));
+        if(memcmp(magic, snapshot_magic_c, sizeof(magic)) != 0) {
+            throw Error(snapshot_invalid_error_c);
+        }
+        if(read_int() != snapshot_version_c) {
+            throw Error("Unsupported snapshot version!");
+        }
+    } catch(...) {
+        if(data) {
+            munmap(const_cast<char*>(data), size);
+        }
+        throw;
+    }
+}
+
+Snapshot_reader::~Snapshot_reader() {
+    if(data) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+int Snapshot_reader::read_int() {
+    int value;
+    read_raw(&value, sizeof(value));
+    return value;
+}
+
+double Snapshot_reader::read_double() {
+    double value;
+    read_raw(&value, sizeof(value));
+    return value;
+}
+
+unsigned char Snapshot_reader::read_byte() {
+    unsigned char value;
+    read_raw(&value, sizeof(value));
+    return value;
+}
+
+// read a byte that must be less than num_choices, such as an enum value
+unsigned char Snapshot_reader::read_choice(int num_choices) {
+    unsigned char value = read_byte();
+    if(value >= num_choices) {
+        throw Error(snapshot_invalid_error_c);
+    }
+    return value;
+}
+
+// read a count of items that are each at least one byte long
+// A count larger than what is left of the file cannot be right.
+size_t Snapshot_reader::read_count() {
+    unsigned long long value;
+    read_raw(&value, sizeof(value));
+    if(value > size - offset) {
+        throw Error(snapshot_invalid_error_c);
+    }
+    return static_cast<size_t>(value);
+}
+
+string Snapshot_reader::read_string() {
+    size_t length = read_count();
+    string value(data + offset, length);
+    offset += length;
+    return value;
+}
+
+// read a reference to a registered Island or Ship; nullptr if none was written
+// Every registered object's name has been interned, so a name without an ID is
+// not registered either.
+shared_ptr<Island> Snapshot_reader::read_island_ref() {
+    string name = read_string();
+    if(name.empty()) {
+        return nullptr;
+    }
+    const shared_ptr<Island>* island_ptr = islands_by_id.find(Name_registry::get_instance().find_id(name));
+    if(!island_ptr) {
+        throw Error(snapshot_invalid_error_c);
+    }
+    return *island_ptr;
+}
+
+shared_ptr<Ship> Snapshot_reader::read_ship_ref() {
+    string name = read_string();
+    if(name.empty()) {
+        return nullptr;
+    }
+    const shared_ptr<Ship>* ship_ptr = ships_by_id.find(Name_registry::get_instance().find_id(name));
+    if(!ship_ptr) {
+        throw Error(snapshot_invalid_error_c);
+    }
+    return *ship_ptr;
+}
+
+// make an object available to references
+// two objects with the same name mean the file is not valid
+void Snapshot_reader::add_island(shared_ptr<Island> island_ptr) {
+    int id = island_ptr->get_id();
+    if(islands_by_id.contains(id) || ships_by_id.contains(id)) {
+        throw Error(snapshot_invalid_error_c);
+    }
+    islands_by_id[id] = island_ptr;
+}
+
+void Snapshot_reader::add_ship(shared_ptr<Ship> ship_ptr) {
+    int id = ship_ptr->get_id();
+    if(islands_by_id.contains(id) || ships_by_id.contains(id)) {
+        throw Error(snapshot_invalid_error_c);
+    }
+    ships_by_id[id] = ship_ptr;
+}
+
+void Snapshot_reader::read_raw(void* destination, size_t num_bytes) {
+    if(num_bytes > size - offset) {
+        throw Error(snapshot_invalid_error_c);
+    }
+    memcpy(destination, data + offset, num_bytes);
+    offset += num_bytes;
+}
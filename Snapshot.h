@@ -0,0 +1,118 @@
+/* Snapshot_writer and Snapshot_reader classes
+A snapshot is a binary file holding the complete state of the simulation, written by
+the "save" command and read back by "load". It starts with a magic string and a
+format version; after that, the Model and each object write their own state as a
+sequence of integers, doubles, bytes and strings, and read it back in the same order.
+Values are stored in the machine's native representation, so a snapshot is meant
+to be loaded on the kind of machine that saved it.
+
+References between objects (a Ship's docked Island, a Warship's target) are written
+as the name of the object referred to. Before any object state is read, the Model
+registers every new Island and Ship with the reader, so that a reference can be
+resolved whatever order the objects come in.
+
+The reader maps the whole file into memory and reads straight out of the mapping.
+Any read past the end of the file, or a value that is out of range, throws
+Error("Invalid snapshot file!").
+*/
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "Id_map.h"
+#include "Island_catalog.h"
+
+class Island;
+class Ship;
+
+class Snapshot_writer {
+public:
+    // create the file and write the header
+    // will throw Error("Could not open file!") if the file cannot be created
+    explicit Snapshot_writer(const std::string& filename);
+
+    // disallow copy/move construction or assignment
+    Snapshot_writer(Snapshot_writer& other)=delete;
+    Snapshot_writer(Snapshot_writer&& other)=delete;
+    Snapshot_writer& operator=(Snapshot_writer& rhs)=delete;
+    Snapshot_writer& operator=(Snapshot_writer&& rhs)=delete;
+
+    void write_int(int value)
+        {write_raw(&value, sizeof(value));}
+    void write_double(double value)
+        {write_raw(&value, sizeof(value));}
+    void write_byte(unsigned char value)
+        {write_raw(&value, sizeof(value));}
+    void write_count(std::size_t count);
+    void write_string(const std::string& value);
+    // write a reference to an Island or Ship; nullptr is allowed
+    void write_island_ref(const std::shared_ptr<Island>& island_ptr);
+    void write_ship_ref(const Ship* ship_ptr);
+
+    // finish the file
+    // will throw Error("Could not write file!") if anything could not be written
+    void close();
+
+private:
+    std::ofstream file;
+
+    void write_raw(const void* source, std::size_t num_bytes)
+        {file.write(static_cast<const char*>(source), num_bytes);}
+};
+
+class Snapshot_reader {
+public:
+    // map the file into memory and check the header
+    // will throw Error("Could not open file!") if the file cannot be read
+    // will throw Error("Invalid snapshot file!") if it is not a snapshot
+    // will throw Error("Unsupported snapshot version!") if it is from another version
+    explicit Snapshot_reader(const std::string& filename);
+    ~Snapshot_reader();
+
+    // disallow copy/move construction or assignment
+    Snapshot_reader(Snapshot_reader& other)=delete;
+    Snapshot_reader(Snapshot_reader&& other)=delete;
+    Snapshot_reader& operator=(Snapshot_reader& rhs)=delete;
+    Snapshot_reader& operator=(Snapshot_reader&& rhs)=delete;
+
+    int read_int();
+    double read_double();
+    unsigned char read_byte();
+    // read a byte that must be less than num_choices, such as an enum value
+    unsigned char read_choice(int num_choices);
+    // read a count of items that are each at least one byte long
+    std::size_t read_count();
+    std::string read_string();
+    // read a reference to a registered Island or Ship; nullptr if none was written
+    std::shared_ptr<Island> read_island_ref();
+    std::shared_ptr<Ship> read_ship_ref();
+
+    // make an object available to references
+    // will throw Error("Invalid snapshot file!") if the name was already added
+    void add_island(std::shared_ptr<Island> island_ptr);
+    void add_ship(std::shared_ptr<Ship> ship_ptr);
+    // the Edition (see Island_catalog) of the Islands being loaded, once they all
+    // have been added, for objects that keep track of Islands by their place in it
+    void set_island_edition(std::shared_ptr<const Island_catalog::Edition> edition)
+        {island_edition = edition;}
+    std::shared_ptr<const Island_catalog::Edition> get_island_edition() const
+        {return island_edition;}
+
+    // true if everything in the file has been read
+    bool at_end() const {return offset == size;}
+
+private:
+    const char* data;
+    std::size_t size;
+    std::size_t offset;
+    // registered objects, by the IDs interned for their names
+    Id_map<std::shared_ptr<Island>> islands_by_id;
+    Id_map<std::shared_ptr<Ship>> ships_by_id;
+    std::shared_ptr<const Island_catalog::Edition> island_edition;
+
+    void read_raw(void* destination, std::size_t num_bytes);
+};
+
+#endif
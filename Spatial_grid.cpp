@@ -0,0 +1,295 @@
+#include "Spatial_grid.h"
+#include "Sim_object.h"
+#include "Geometry.h"
+#include "Thread_pool.h"
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+using std::floor;
+using std::function;
+using std::max;
+using std::min;
+using std::numeric_limits;
+using std::pair;
+using std::shared_ptr;
+using std::vector;
+
+// cell_size_ is the width of a cell in nm
+Spatial_grid::Spatial_grid(double cell_size_) : cell_size(cell_size_),
+    min_ix(INT_MAX), max_ix(INT_MIN), min_iy(INT_MAX), max_iy(INT_MIN) { }
+
+// add an object at location; an object already present is moved instead
+void Spatial_grid::insert(shared_ptr<Sim_object> object_ptr, Point location) {
+    if(const Place* place = places.find(object_ptr->get_id())) {
+        remove_entry(Place(*place));
+    }
+    add_entry(object_ptr, location);
+}
+
+// note that the object with this id may have moved; no effect if it is not present
+void Spatial_grid::mark_moved(int id) {
+    const Place* place = places.find(id);
+    if(!place) {
+        return;
+    }
+    Cell& cell = cells[place->cell_number];
+    if(!cell.marked) {
+        cell.marked = true;
+        marked_cells.push_back(place->cell_number);
+    }
+}
+
+// bring the location of every object marked as moved up to date, using pool
+// to refresh regions in parallel if it is not nullptr
+/* Each marked cell only touches its own entries while it is refreshed, so the
+cells can be shared out among threads. The departures are then carried out
+serially. Within a cell they are carried out from the highest index down, so
+that the entry moved into each hole (the cell's last) is never one still queued
+to leave; entries arriving from other cells go after all of those. */
+void Spatial_grid::refresh(Thread_pool* pool) {
+    if(marked_cells.empty()) {
+        return;
+    }
+    auto refresh_cells = [this](int begin, int end) {
+        for(int i = begin; i < end; ++i) {
+            refresh_cell(cells[marked_cells[i]]);
+        }
+    };
+    int num_marked = static_cast<int>(marked_cells.size());
+    if(pool) {
+        pool->parallel_for(num_marked, refresh_cells);
+    } else {
+        refresh_cells(0, num_marked);
+    }
+    // add_entry can add cells, so the departures are moved out of the cell while
+    // they are carried out, and the emptied vector is handed back afterwards
+    for(int cell_number : marked_cells) {
+        cells[cell_number].marked = false;
+        departing.swap(cells[cell_number].departures);
+        for(auto departure_it = departing.rbegin(); departure_it != departing.rend(); ++departure_it) {
+            shared_ptr<Sim_object> moving_ptr = cells[cell_number].entries[departure_it->first].object_ptr;
+            remove_entry(Place{cell_number, departure_it->first});
+            add_entry(moving_ptr, departure_it->second);
+        }
+        departing.clear();
+        departing.swap(cells[cell_number].departures);
+    }
+    marked_cells.clear();
+}
+
+// remove an object; no error if it is not present
+void Spatial_grid::remove(const Sim_object* object_ptr) {
+    if(const Place* place = places.find(object_ptr->get_id())) {
+        remove_entry(Place(*place));
+    }
+}
+
+// remove every object
+void Spatial_grid::clear() {
+    cells.clear();
+    cell_numbers.clear();
+    places.clear();
+    marked_cells.clear();
+    min_ix = min_iy = INT_MAX;
+    max_ix = max_iy = INT_MIN;
+}
+
+// the location of the object with this id as of the last refresh, or nullptr
+// if it is not present
+const Point* Spatial_grid::find_location(int id) const {
+    const Place* place = places.find(id);
+    if(!place) {
+        return nullptr;
+    }
+    return &cells[place->cell_number].entries[place->index].location;
+}
+
+// Append to found every object at a distance <= radius from center, in no
+// particular order.
+// If the circle covers more cells than are in use, the used cells are scanned instead.
+void Spatial_grid::find_within(Point center, double radius, vector<shared_ptr<Sim_object>>& found) const {
+    if(cells.empty() || radius < 0.) {
+        return;
+    }
+    auto check_cell = [&center, radius, &found](const Cell& cell) {
+        for(const Entry& entry : cell.entries) {
+            if(cartesian_distance(center, entry.location) <= radius) {
+                found.push_back(entry.object_ptr);
+            }
+        }
+    };
+    int low_ix = max(cell_coordinate(center.x - radius), min_ix);
+    int high_ix = min(cell_coordinate(center.x + radius), max_ix);
+    int low_iy = max(cell_coordinate(center.y - radius), min_iy);
+    int high_iy = min(cell_coordinate(center.y + radius), max_iy);
+    if(low_ix > high_ix || low_iy > high_iy) {
+        return;
+    }
+    double covered_cells = (double(high_ix) - low_ix + 1) * (double(high_iy) - low_iy + 1);
+    if(covered_cells > cells.size()) {
+        for(const Cell& cell : cells) {
+            check_cell(cell);
+        }
+        return;
+    }
+    for(int ix = low_ix; ix <= high_ix; ++ix) {
+        for(int iy = low_iy; iy <= high_iy; ++iy) {
+            const Cell* cell = get_cell(ix, iy);
+            if(cell) {
+                check_cell(*cell);
+            }
+        }
+    }
+}
+
+// Find the least distance d from center to an object accepted by accept, then
+// append to found every accepted object at a distance <= d + slack, in no
+// particular order. found is left unchanged if no object is accepted.
+/* The rings of cells around the center cell are searched in turn. Every point in
+ring r is at least (r - 1) cell widths from center, so once that exceeds the best
+distance found plus slack, no later ring can contribute. If the rings reach more
+cells than are in use before that happens, the used cells are scanned instead. */
+void Spatial_grid::find_nearest(Point center, double slack,
+                                const function<bool(const shared_ptr<Sim_object>&)>& accept,
+                                vector<shared_ptr<Sim_object>>& found) const {
+    if(cells.empty()) {
+        return;
+    }
+    struct Candidate {
+        shared_ptr<Sim_object> object_ptr;
+        double distance;
+    };
+    vector<Candidate> candidates;
+    double best = numeric_limits<double>::infinity();
+    auto check_cell = [&](const Cell& cell) {
+        for(const Entry& entry : cell.entries) {
+            if(!accept(entry.object_ptr)) {
+                continue;
+            }
+            double distance = cartesian_distance(center, entry.location);
+            if(distance <= best + slack) {
+                candidates.push_back(Candidate{entry.object_ptr, distance});
+                best = min(best, distance);
+            }
+        }
+    };
+    int center_ix = cell_coordinate(center.x), center_iy = cell_coordinate(center.y);
+    // no ring beyond this one holds any cell that has been used
+    int last_ring = max(max(center_ix - min_ix, max_ix - center_ix),
+                        max(center_iy - min_iy, max_iy - center_iy));
+    double ring_cells_examined = 0.;
+    bool scan_all = false;
+    for(int ring = 0; ring <= last_ring; ++ring) {
+        if((ring - 1) * cell_size > best + slack) {
+            break;
+        }
+        ring_cells_examined += (ring == 0) ? 1. : 8. * ring;
+        if(ring_cells_examined > cells.size()) {
+            scan_all = true;
+            break;
+        }
+        for(int ix = center_ix - ring; ix <= center_ix + ring; ++ix) {
+            // only the top and bottom rows are needed except at the left and right edges
+            int step = (ix == center_ix - ring || ix == center_ix + ring || ring == 0) ? 1 : 2 * ring;
+            for(int iy = center_iy - ring; iy <= center_iy + ring; iy += step) {
+                const Cell* cell = get_cell(ix, iy);
+                if(cell) {
+                    check_cell(*cell);
+                }
+            }
+        }
+    }
+    if(scan_all) {
+        candidates.clear();
+        best = numeric_limits<double>::infinity();
+        for(const Cell& cell : cells) {
+            check_cell(cell);
+        }
+    }
+    for(const Candidate& candidate : candidates) {
+        if(candidate.distance <= best + slack) {
+            found.push_back(candidate.object_ptr);
+        }
+    }
+}
+
+// cell coordinates of a location, clamped so that far-away objects share the edge cells
+int Spatial_grid::cell_coordinate(double value) const {
+    double cell = floor(value / cell_size);
+    if(cell < INT_MIN / 2) {
+        return INT_MIN / 2;
+    }
+    if(cell > INT_MAX / 2) {
+        return INT_MAX / 2;
+    }
+    return static_cast<int>(cell);
+}
+
+// the coordinates' bits side by side; shifted unsigned, since ix can be negative
+unsigned long long Spatial_grid::make_key(int ix, int iy) {
+    return (static_cast<unsigned long long>(static_cast<unsigned int>(ix)) << 32) | static_cast<unsigned int>(iy);
+}
+
+// the Cell (ix, iy), or nullptr if it is empty
+const Spatial_grid::Cell* Spatial_grid::get_cell(int ix, int iy) const {
+    auto cell_number_it = cell_numbers.find(make_key(ix, iy));
+    if(cell_number_it == cell_numbers.end() || cells[cell_number_it->second].entries.empty()) {
+        return nullptr;
+    }
+    return &cells[cell_number_it->second];
+}
+
+// the number of the Cell for key, created if need be
+int Spatial_grid::get_cell_number(unsigned long long key) {
+    // look first, since emplace may allocate a node even when the key is present
+    auto cell_number_it = cell_numbers.find(key);
+    if(cell_number_it != cell_numbers.end()) {
+        return cell_number_it->second;
+    }
+    int cell_number = static_cast<int>(cells.size());
+    cell_numbers.emplace(key, cell_number);
+    cells.push_back(Cell{key, vector<Entry>(), vector<pair<int, Point>>(), false});
+    return cell_number;
+}
+
+// re-read the locations of a marked Cell's objects and queue its departures
+void Spatial_grid::refresh_cell(Cell& cell) {
+    for(int index = 0; index < static_cast<int>(cell.entries.size()); ++index) {
+        Entry& entry = cell.entries[index];
+        Point location = entry.object_ptr->get_location();
+        if(key_of(location) == cell.key) {
+            entry.location = location;
+        } else {
+            cell.departures.push_back(pair<int, Point>(index, location));
+        }
+    }
+}
+
+void Spatial_grid::add_entry(shared_ptr<Sim_object> object_ptr, Point location) {
+    int ix = cell_coordinate(location.x), iy = cell_coordinate(location.y);
+    int cell_number = get_cell_number(make_key(ix, iy));
+    vector<Entry>& entries = cells[cell_number].entries;
+    int id = object_ptr->get_id();
+    places[id] = Place{cell_number, static_cast<int>(entries.size())};
+    entries.push_back(Entry{object_ptr, location, id});
+    min_ix = min(min_ix, ix);
+    max_ix = max(max_ix, ix);
+    min_iy = min(min_iy, iy);
+    max_iy = max(max_iy, iy);
+}
+
+// the last Entry of the cell fills the hole
+void Spatial_grid::remove_entry(const Place& place) {
+    vector<Entry>& entries = cells[place.cell_number].entries;
+    int removed_id = entries[place.index].id;
+    if(place.index != static_cast<int>(entries.size()) - 1) {
+        entries[place.index] = entries.back();
+        places[entries[place.index].id].index = place.index;
+    }
+    entries.pop_back();
+    places.erase(removed_id);
+}
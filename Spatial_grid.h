@@ -0,0 +1,117 @@
+/* Spatial_grid class
+A Spatial_grid is a uniform grid index of Sim_object locations, used to answer
+"what is near this point" without looking at every object. The plane is cut into
+square cells, or regions; each region owns the entries of the objects whose last
+known location falls in it.
+
+Objects are inserted at a location and removed when they go away, each in constant
+time on average. Moving objects are not followed one move at a time. Instead, an
+object that may have moved is marked, which only flags its region, and refresh
+brings all flagged regions up to date at once, at a tick boundary. Each flagged
+region re-reads the locations of its own objects and queues those that have
+crossed into another region; regions are independent, so this can be spread over
+a Thread_pool. The queued objects then migrate to their new regions one at a time.
+Queries see the locations as of the last refresh.
+
+find_within reports the objects within a radius of a point by looking only at the
+cells that the circle overlaps. find_nearest searches outward from a point ring by
+ring and stops as soon as no farther cell can hold a closer object.
+*/
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+#include "Geometry.h"
+#include "Id_map.h"
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Sim_object;
+class Thread_pool;
+
+class Spatial_grid {
+public:
+    // cell_size_ is the width of a cell in nm
+    explicit Spatial_grid(double cell_size_);
+
+    // disallow copy/move construction or assignment
+    Spatial_grid(Spatial_grid& other)=delete;
+    Spatial_grid(Spatial_grid&& other)=delete;
+    Spatial_grid& operator=(Spatial_grid& rhs)=delete;
+    Spatial_grid& operator=(Spatial_grid&& rhs)=delete;
+
+    // add an object at location; an object already present is moved instead
+    void insert(std::shared_ptr<Sim_object> object_ptr, Point location);
+    // note that the object with this id may have moved; no effect if it is not present
+    void mark_moved(int id);
+    // bring the location of every object marked as moved up to date, using pool
+    // to refresh regions in parallel if it is not nullptr
+    void refresh(Thread_pool* pool);
+    // remove an object; no error if it is not present
+    void remove(const Sim_object* object_ptr);
+    // remove every object
+    void clear();
+
+    // the location of the object with this id as of the last refresh, or nullptr
+    // if it is not present
+    const Point* find_location(int id) const;
+    // Append to found every object at a distance <= radius from center, in no
+    // particular order.
+    void find_within(Point center, double radius,
+                     std::vector<std::shared_ptr<Sim_object>>& found) const;
+    // Find the least distance d from center to an object accepted by accept, then
+    // append to found every accepted object at a distance <= d + slack, in no
+    // particular order. found is left unchanged if no object is accepted.
+    void find_nearest(Point center, double slack,
+                      const std::function<bool(const std::shared_ptr<Sim_object>&)>& accept,
+                      std::vector<std::shared_ptr<Sim_object>>& found) const;
+
+private:
+    struct Entry {
+        std::shared_ptr<Sim_object> object_ptr;
+        Point location;
+        int id;
+    };
+    struct Cell {
+        unsigned long long key;
+        std::vector<Entry> entries;
+        // entries found by refresh to have left the cell: index and new location
+        std::vector<std::pair<int, Point>> departures;
+        bool marked;    // an object in the cell was marked as moved
+    };
+    // where an object's Entry is kept
+    struct Place {
+        int cell_number;
+        int index;
+    };
+
+    double cell_size;
+    // cells are never discarded, so cell numbers stay valid until clear()
+    std::vector<Cell> cells;
+    std::unordered_map<unsigned long long, int> cell_numbers;
+    Id_map<Place> places;
+    // numbers of the cells marked since the last refresh
+    std::vector<int> marked_cells;
+    // the departures of the cell being refreshed, kept so that its storage is reused
+    std::vector<std::pair<int, Point>> departing;
+    // bounds of the cells that have ever been used
+    int min_ix, max_ix, min_iy, max_iy;
+
+    // cell coordinates of a location
+    int cell_coordinate(double value) const;
+    // the coordinates' bits side by side; shifted unsigned, since ix can be negative
+    static unsigned long long make_key(int ix, int iy);
+    unsigned long long key_of(Point location) const
+        {return make_key(cell_coordinate(location.x), cell_coordinate(location.y));}
+    // the Cell (ix, iy), or nullptr if it is empty
+    const Cell* get_cell(int ix, int iy) const;
+    // the number of the Cell for key, created if need be
+    int get_cell_number(unsigned long long key);
+    // re-read the locations of a marked Cell's objects and queue its departures
+    void refresh_cell(Cell& cell);
+    void add_entry(std::shared_ptr<Sim_object> object_ptr, Point location);
+    void remove_entry(const Place& place);
+};
+
+#endif
@@ -1,11 +1,16 @@
 #include "Tanker.h"
 #include "Island.h"
+#include "Model.h"
+#include "Snapshot.h"
+#include "Telemetry.h"
 #include "Utility.h"
+#include "Event_log.h"
 #include <memory>
 #include <string>
 #include <iostream>
 using std::cout;
 using std::endl;
+using std::ostream;
 using std::shared_ptr;
 using std::static_pointer_cast;
 using std::string;
@@ -81,7 +86,8 @@ void Tanker::set_load_destination(shared_ptr<Island> load_destination_) {
     if(load_destination == unload_destination) {
         throw Error("Load and unload cargo destinations are the same!");
     }
-    cout << get_name() << " will load at " << load_destination->get_name() << endl;
+    if(ostream* log = log_event(Event_category_e::ORDERS, Event_level_e::NOTICE))
+        *log << get_name() << " will load at " << load_destination->get_name() << '\n';
     update_loading();
 }
 
@@ -93,7 +99,8 @@ void Tanker::set_unload_destination(shared_ptr<Island> unload_destination_) {
     if(load_destination == unload_destination) {
         throw Error("Load and unload cargo destinations are the same!");
     }
-    cout << get_name() << " will unload at " << unload_destination->get_name() << endl;
+    if(ostream* log = log_event(Event_category_e::ORDERS, Event_level_e::NOTICE))
+        *log << get_name() << " will unload at " << unload_destination->get_name() << '\n';
     update_loading();
 }
 
@@ -102,7 +109,8 @@ void Tanker::stop() {
     Ship::stop();
     unload_destination = load_destination = nullptr;
     cargo_state = Cargo_State_e::NO_CARGO_DESTINATIONS;
-    cout << get_name() << tanker_no_cargo_destinations_c << endl;
+    if(ostream* log = log_event(Event_category_e::CARGO, Event_level_e::NOTICE))
+        *log << get_name() << tanker_no_cargo_destinations_c << '\n';
 }
 
 void Tanker::update() {
@@ -110,7 +118,8 @@ void Tanker::update() {
     if(!can_move()) {
         cargo_state = Cargo_State_e::NO_CARGO_DESTINATIONS;
         unload_destination = load_destination = nullptr;
-        cout << get_name() << tanker_no_cargo_destinations_c << endl;
+        if(ostream* log = log_event(Event_category_e::CARGO, Event_level_e::NOTICE))
+            *log << get_name() << tanker_no_cargo_destinations_c << '\n';
     }
     else if(cargo_state == Cargo_State_e::NO_CARGO_DESTINATIONS) { return; }
     else if(cargo_state == Cargo_State_e::MOVING_TO_LOADING && !is_moving() &&
@@ -132,7 +141,8 @@ void Tanker::update() {
             cargo_state = Cargo_State_e::MOVING_TO_UNLOADING;
         } else {
             cargo += load_destination->provide_fuel(cargo_needed);
-            cout << get_name() << " now has " << cargo << " of cargo" << endl;
+            if(ostream* log = log_event(Event_category_e::CARGO, Event_level_e::NOTICE))
+                *log << get_name() << " now has " << cargo << " of cargo" << '\n';
         }
     }
     else if(cargo_state == Cargo_State_e::UNLOADING) {
@@ -147,6 +157,35 @@ void Tanker::update() {
     return;
 }
 
+// idle if the Ship is idle and there are no cargo destinations
+bool Tanker::is_idle() const {
+    return Ship::is_idle() && cargo_state == Cargo_State_e::NO_CARGO_DESTINATIONS;
+}
+
+// add the cargo and cargo cycle to the Ship's state
+void Tanker::save_state(Snapshot_writer& writer) const {
+    Ship::save_state(writer);
+    writer.write_double(cargo);
+    writer.write_byte(static_cast<unsigned char>(cargo_state));
+    writer.write_island_ref(load_destination);
+    writer.write_island_ref(unload_destination);
+}
+
+void Tanker::load_state(Snapshot_reader& reader) {
+    Ship::load_state(reader);
+    cargo = reader.read_double();
+    cargo_state = static_cast<Cargo_State_e>(reader.read_choice(static_cast<int>(Cargo_State_e::MOVING_TO_UNLOADING) + 1));
+    load_destination = reader.read_island_ref();
+    unload_destination = reader.read_island_ref();
+}
+
+// add the cargo to the Ship's telemetry
+void Tanker::report_telemetry(Telemetry_record& record) const {
+    Ship::report_telemetry(record);
+    record.fields |= Telemetry_record::CARGO;
+    record.cargo = cargo;
+}
+
 void Tanker::describe() const {
     cout << "\nTanker ";
     Ship::describe();
@@ -174,7 +213,8 @@ void Tanker::describe() const {
     cout << endl;
 }
 
-void Tanker::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr) {
-    Ship::receive_hit(hit_force, attacker_ptr);
+// tell the attacker it has attacked a Tanker
+void Tanker::respond_to_hit(shared_ptr<Ship> attacker_ptr) {
+    Model::get_instance().wake(shared_from_this());
     attacker_ptr->respond_to_attack(static_pointer_cast<Tanker>(shared_from_this()));
 }
\ No newline at end of file
@@ -39,11 +39,22 @@ public:
 	void stop() override;
 	
 	void update() override;
+	// idle if the Ship is idle and there are no cargo destinations
+	bool is_idle() const override;
+	const char* get_type_name() const override
+		{return "Tanker";}
+	// add the cargo and cargo cycle to the Ship's state
+	void save_state(Snapshot_writer& writer) const override;
+	void load_state(Snapshot_reader& reader) override;
+	// add the cargo to the Ship's telemetry
+	void report_telemetry(Telemetry_record& record) const override;
 	void describe() const override;
     
-    void receive_hit(int hit_force, std::shared_ptr<Ship> attacker_ptr) override;
+    // tell the attacker it has attacked a Tanker
+    void respond_to_hit(std::shared_ptr<Ship> attacker_ptr) override;
     
 private:
+    // MOVING_TO_UNLOADING must stay last; snapshots check states against it
     enum class Cargo_State_e {
         NO_CARGO_DESTINATIONS, UNLOADING, MOVING_TO_LOADING,
         LOADING, MOVING_TO_UNLOADING
@@ -0,0 +1,215 @@
+#include "Telemetry.h"
+#include "Utility.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+using std::ios;
+using std::llround;
+using std::size_t;
+using std::strcmp;
+using std::string;
+using std::vector;
+
+const char telemetry_magic_c[8] = {'S', 'H', 'I', 'P', 'T', 'E', 'L', 'E'};
+const unsigned char telemetry_version_c = 1;
+// doubles are written in units of 1 / telemetry_scale_c
+const double telemetry_scale_c = 10000.;
+// the buffer is written out once it holds this much
+const size_t telemetry_block_size_c = 1 << 16;
+enum Telemetry_tag_e : unsigned char { END, TICK, NEW, CHANGED, GONE };
+// the doubles of a Telemetry_record in the order they are kept in a Written_state,
+// and the field flag each belongs to
+const int num_telemetry_doubles_c = 6;
+const int cargo_index_c = 5;
+const unsigned char telemetry_double_fields_c[num_telemetry_doubles_c] = {
+    Telemetry_record::LOCATION, Telemetry_record::LOCATION, Telemetry_record::COURSE,
+    Telemetry_record::SPEED, Telemetry_record::FUEL, Telemetry_record::CARGO};
+
+// create the file and write the header; a tick is written every interval_ ticks
+Telemetry_writer::Telemetry_writer(const string& filename, int interval_) :
+    file(filename, ios::out | ios::binary | ios::trunc), interval(interval_),
+    tick_time(0), last_time(0), tick_number(0), tick_written(false), last_id(0) {
+    if(!file) {
+        throw Error("Could not open file!");
+    }
+    buffer.append(telemetry_magic_c, sizeof(telemetry_magic_c));
+    buffer += static_cast<char>(telemetry_version_c);
+    write_varint(interval);
+}
+
+// write out what is still buffered if close was not called
+Telemetry_writer::~Telemetry_writer() {
+    if(file.is_open()) {
+        file.write(buffer.data(), buffer.size());
+    }
+}
+
+// the number of ticks after time that come before the next one to be written
+int Telemetry_writer::ticks_until_due(int time) const {
+    int remainder = time % interval;
+    if(remainder < 0) {
+        remainder += interval;
+    }
+    return interval - remainder - 1;
+}
+
+// start the tick at time; every object is then added, and the tick ended
+void Telemetry_writer::begin_tick(int time) {
+    tick_time = time;
+    ++tick_number;
+    tick_written = false;
+    last_id = 0;
+}
+
+void Telemetry_writer::add_object(int id, const char* type_name, const string& name,
+                                  const Telemetry_record& record) {
+    Written_state* state = written_states.find(id);
+    bool is_new = !state;
+    if(is_new) {
+        state = &written_states[id];
+        written_ids.push_back(id);
+    } else if(state->removed || strcmp(state->type_name, type_name) != 0) {
+        // another object has taken the name of the one written before
+        begin_entry(GONE, id);
+        is_new = true;
+    }
+    if(is_new) {
+        *state = Written_state{{0, 0, 0, 0, 0, 0}, 0, 0, 0, type_name, false};
+    }
+    state->last_tick = tick_number;
+    long long values[num_telemetry_doubles_c];
+    unsigned char changed = find_changes(record, *state, is_new, values);
+    if(is_new) {
+        begin_entry(NEW, id);
+        write_string(type_name);
+        write_string(name);
+    } else if(changed) {
+        begin_entry(CHANGED, id);
+    } else {
+        return;
+    }
+    write_fields(record, changed, values, *state);
+}
+
+// the object has been removed; if an object of its name is added later, it is new
+void Telemetry_writer::remove_object(int id) {
+    if(Written_state* state = written_states.find(id)) {
+        state->removed = true;
+    }
+}
+
+// record the objects not added since the last tick as gone, and end the tick
+void Telemetry_writer::end_tick() {
+    size_t kept = 0;
+    for(int id : written_ids) {
+        if(written_states.find(id)->last_tick == tick_number) {
+            written_ids[kept++] = id;
+        } else {
+            begin_entry(GONE, id);
+            written_states.erase(id);
+        }
+    }
+    written_ids.resize(kept);
+    if(tick_written) {
+        buffer += static_cast<char>(END);
+        flush_buffer(false);
+    }
+}
+
+// write out what is buffered and finish the file
+// will throw Error("Could not write file!") if anything could not be written
+void Telemetry_writer::close() {
+    flush_buffer(true);
+    file.close();
+    if(file.fail()) {
+        throw Error("Could not write file!");
+    }
+}
+
+// start an entry of the current tick, writing the tick's start first if need be
+void Telemetry_writer::begin_entry(unsigned char kind, int id) {
+    if(!tick_written) {
+        buffer += static_cast<char>(TICK);
+        write_signed(static_cast<long long>(tick_time) - last_time);
+        last_time = tick_time;
+        tick_written = true;
+    }
+    buffer += static_cast<char>(kind);
+    write_signed(static_cast<long long>(id) - last_id);
+    last_id = id;
+}
+
+// the fields of record that differ from state, or all it has if is_new, with its
+// doubles in the units written put in values
+unsigned char Telemetry_writer::find_changes(const Telemetry_record& record, const Written_state& state,
+                                             bool is_new, long long values[]) {
+    const double doubles[num_telemetry_doubles_c] = {record.location.x, record.location.y,
+        record.course, record.speed, record.fuel, record.cargo};
+    unsigned char changed = 0;
+    for(int i = 0; i < num_telemetry_doubles_c; ++i) {
+        if(!(record.fields & telemetry_double_fields_c[i])) {
+            continue;
+        }
+        values[i] = llround(doubles[i] * telemetry_scale_c);
+        if(is_new || values[i] != state.values[i]) {
+            changed |= telemetry_double_fields_c[i];
+        }
+    }
+    if((record.fields & Telemetry_record::SHIP_STATE) && (is_new || record.ship_state != state.ship_state)) {
+        changed |= Telemetry_record::SHIP_STATE;
+    }
+    if((record.fields & Telemetry_record::RESISTANCE) && (is_new || record.resistance != state.resistance)) {
+        changed |= Telemetry_record::RESISTANCE;
+    }
+    return changed;
+}
+
+// write the changed fields in flag order, and remember them in state
+void Telemetry_writer::write_fields(const Telemetry_record& record, unsigned char changed,
+                                   const long long values[], Written_state& state) {
+    buffer += static_cast<char>(changed);
+    auto write_double = [this, changed, values, &state](int i) {
+        if(changed & telemetry_double_fields_c[i]) {
+            write_signed(values[i] - state.values[i]);
+            state.values[i] = values[i];
+        }
+    };
+    // location, course, speed and fuel come before the ship state and resistance
+    for(int i = 0; i < cargo_index_c; ++i) {
+        write_double(i);
+    }
+    if(changed & Telemetry_record::SHIP_STATE) {
+        buffer += static_cast<char>(record.ship_state);
+        state.ship_state = record.ship_state;
+    }
+    if(changed & Telemetry_record::RESISTANCE) {
+        write_signed(static_cast<long long>(record.resistance) - state.resistance);
+        state.resistance = record.resistance;
+    }
+    write_double(cargo_index_c);
+}
+
+void Telemetry_writer::write_varint(unsigned long long value) {
+    while(value >= 0x80) {
+        buffer += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    buffer += static_cast<char>(value);
+}
+
+void Telemetry_writer::write_string(const string& value) {
+    write_varint(value.size());
+    buffer += value;
+}
+
+// write the buffer to the file if it has grown large, or if all is true
+void Telemetry_writer::flush_buffer(bool all) {
+    if(buffer.size() < telemetry_block_size_c && !all) {
+        return;
+    }
+    file.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
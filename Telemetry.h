@@ -0,0 +1,126 @@
+/* Telemetry_record and Telemetry_writer classes
+A telemetry file records the state of every object as the simulation runs, for
+analysis offline. "open_telemetry" starts one, to which the Model writes the state
+at the end of every update whose time is a multiple of the interval, and
+"close_telemetry" finishes it. Only what has changed since the last tick written is
+recorded.
+
+The file starts with the magic string SHIPTELE, a format version byte, and the
+interval. Integers are written as varints: 7 bits to a byte, low bits first, with the
+top bit set on every byte but the last; signed integers are zigzag encoded first
+(0, -1, 1, -2 ... as 0, 1, 2, 3 ...). A string is its length and then its bytes.
+
+A tick is written only if something changed: a TICK byte and the change in time since
+the previous tick written (signed, since loading a snapshot can turn the time back),
+then entries, then an END byte. Each entry is a kind byte and the change in object ID
+from the previous entry of the tick (signed, starting from 0), followed by:
+    NEW: the type name and name of an object not seen before, then its fields
+    CHANGED: its fields that have changed
+    GONE: nothing; the object has been removed
+An object that was removed since the last tick written, or has another type than
+the one written, is written as GONE and then NEW, even though its name and so its
+ID are the same.
+Fields are a byte of Field_e flags, then the flagged fields in flag order. A double
+is written in units of 1/10000 (finer than the two decimals the text output shows),
+and it and the resistance as the signed change from the value written before, or
+from 0 for a NEW entry; the ship state is a byte, the Ship_State_e value.
+
+Output is gathered in a buffer and written out in large blocks. A write that fails
+is reported by close.
+*/
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+#include "Geometry.h"
+#include "Id_map.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+// the state of an object as the telemetry records it
+struct Telemetry_record {
+    enum Field_e : unsigned char { LOCATION = 1, COURSE = 2, SPEED = 4, FUEL = 8,
+                                   SHIP_STATE = 16, RESISTANCE = 32, CARGO = 64 };
+
+    unsigned char fields;   // the fields that the object has
+    Point location;
+    double course;
+    double speed;
+    double fuel;
+    double cargo;
+    int ship_state;
+    int resistance;
+};
+
+class Telemetry_writer {
+public:
+    // create the file and write the header; a tick is written every interval_ ticks
+    // will throw Error("Could not open file!") if the file cannot be created
+    Telemetry_writer(const std::string& filename, int interval_);
+    // write out what is still buffered if close was not called
+    ~Telemetry_writer();
+
+    // disallow copy/move construction or assignment
+    Telemetry_writer(Telemetry_writer& other)=delete;
+    Telemetry_writer(Telemetry_writer&& other)=delete;
+    Telemetry_writer& operator=(Telemetry_writer& rhs)=delete;
+    Telemetry_writer& operator=(Telemetry_writer&& rhs)=delete;
+
+    // true if the tick at time is to be written
+    bool is_due(int time) const
+        {return time % interval == 0;}
+    // the number of ticks after time that come before the next one to be written
+    int ticks_until_due(int time) const;
+
+    // start the tick at time; every object is then added, and the tick ended
+    void begin_tick(int time);
+    void add_object(int id, const char* type_name, const std::string& name,
+                    const Telemetry_record& record);
+    // the object has been removed; if an object of its name is added later, it is new
+    void remove_object(int id);
+    // record the objects not added since the last tick as gone, and end the tick
+    void end_tick();
+
+    // write out what is buffered and finish the file
+    // will throw Error("Could not write file!") if anything could not be written
+    void close();
+
+private:
+    // what was last written for an object, in the units written
+    struct Written_state {
+        long long values[6];    // x, y, course, speed, fuel, cargo
+        int ship_state;
+        int resistance;
+        int last_tick;          // tick_number when the object was last added
+        const char* type_name;  // as it was written in the NEW entry
+        bool removed;           // removed since it was last added
+    };
+
+    std::ofstream file;
+    std::string buffer;
+    int interval;
+    int tick_time;
+    int last_time;              // time of the last tick written
+    int tick_number;            // counts the ticks begun
+    bool tick_written;          // the current tick's TICK byte is in the buffer
+    int last_id;                // ID of the previous entry of the current tick
+    Id_map<Written_state> written_states;
+    std::vector<int> written_ids;   // the IDs with a Written_state
+
+    // start an entry of the current tick, writing the tick's start first if need be
+    void begin_entry(unsigned char kind, int id);
+    // the fields of record that differ from state, or all it has if is_new, with its
+    // doubles in the units written put in values
+    static unsigned char find_changes(const Telemetry_record& record, const Written_state& state,
+                                      bool is_new, long long values[]);
+    // write the changed fields in flag order, and remember them in state
+    void write_fields(const Telemetry_record& record, unsigned char changed,
+                      const long long values[], Written_state& state);
+    void write_varint(unsigned long long value);
+    void write_signed(long long value)
+        {write_varint((static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63));}
+    void write_string(const std::string& value);
+    // write the buffer to the file if it has grown large, or if all is true
+    void flush_buffer(bool all);
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "Thread_pool.h"
+#include <functional>
+#include <mutex>
+#include <thread>
+using std::condition_variable;
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::thread;
+using std::unique_lock;
+
+// start num_threads_ - 1 workers; the caller of parallel_for is the remaining thread
+Thread_pool::Thread_pool(int num_threads_) :
+    num_threads(num_threads_ < 1 ? 1 : num_threads_), current_task(nullptr),
+    current_count(0), generation(0), chunks_remaining(0), stopping(false) {
+    for(int i = 1; i < num_threads; ++i) {
+        workers.push_back(thread(&Thread_pool::worker_loop, this, i));
+    }
+}
+
+// tell the workers to quit and wait for them
+Thread_pool::~Thread_pool() {
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        stopping = true;
+    }
+    work_cv.notify_all();
+    for(thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Call task(begin, end) for each chunk of [0, count), one chunk per thread,
+// and return when all of them are finished. task must not throw.
+void Thread_pool::parallel_for(int count, const function<void(int, int)>& task) {
+    if(count <= 0) {
+        return;
+    }
+    if(workers.empty()) {
+        task(0, count);
+        return;
+    }
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        current_task = &task;
+        current_count = count;
+        chunks_remaining = num_threads - 1;
+        ++generation;
+    }
+    work_cv.notify_all();
+    run_chunk(0);
+    unique_lock<mutex> lock(pool_mutex);
+    done_cv.wait(lock, [this] { return chunks_remaining == 0; });
+    current_task = nullptr;
+}
+
+// run chunk chunk_index of the current task
+void Thread_pool::run_chunk(int chunk_index) {
+    // widen before multiplying so huge counts do not overflow
+    int begin = static_cast<int>(static_cast<long long>(current_count) * chunk_index / num_threads);
+    int end = static_cast<int>(static_cast<long long>(current_count) * (chunk_index + 1) / num_threads);
+    if(begin < end) {
+        (*current_task)(begin, end);
+    }
+}
+
+// wait for work, run our chunk, repeat until told to stop
+void Thread_pool::worker_loop(int chunk_index) {
+    int seen_generation = 0;
+    while(true) {
+        {
+            unique_lock<mutex> lock(pool_mutex);
+            work_cv.wait(lock, [this, seen_generation] { return stopping || generation != seen_generation; });
+            if(stopping) {
+                return;
+            }
+            seen_generation = generation;
+        }
+        run_chunk(chunk_index);
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            --chunks_remaining;
+        }
+        done_cv.notify_one();
+    }
+}
@@ -0,0 +1,54 @@
+/* Thread_pool class
+A Thread_pool keeps a fixed set of worker threads alive for the life of the pool
+and uses them to run a task over a range of indices in parallel. The range is split
+into one contiguous chunk per thread; the calling thread runs the first chunk itself,
+and parallel_for does not return until every chunk is done. Chunk i is always run by
+the same thread, so data handed to a given chunk stays with one core from call to call.
+*/
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Thread_pool {
+public:
+    // start num_threads_ - 1 workers; the caller of parallel_for is the remaining thread
+    explicit Thread_pool(int num_threads_);
+    // tell the workers to quit and wait for them
+    ~Thread_pool();
+
+    // disallow copy/move construction or assignment
+    Thread_pool(Thread_pool& other)=delete;
+    Thread_pool(Thread_pool&& other)=delete;
+    Thread_pool& operator=(Thread_pool& rhs)=delete;
+    Thread_pool& operator=(Thread_pool&& rhs)=delete;
+
+    // number of threads taking part in parallel_for, including the caller
+    int get_num_threads() const {return num_threads;}
+
+    // Call task(begin, end) for each chunk of [0, count), one chunk per thread,
+    // and return when all of them are finished. task must not throw.
+    void parallel_for(int count, const std::function<void(int, int)>& task);
+
+private:
+    int num_threads;
+    std::vector<std::thread> workers;
+    std::mutex pool_mutex;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+    const std::function<void(int, int)>* current_task;
+    int current_count;
+    int generation;         // bumped each time a new task is posted
+    int chunks_remaining;
+    bool stopping;
+
+    // run chunk chunk_index of the current task
+    void run_chunk(int chunk_index);
+    // wait for work, run our chunk, repeat until told to stop
+    void worker_loop(int chunk_index);
+};
+
+#endif
@@ -1,4 +1,14 @@
 #include "Utility.h"
+#include <iostream>
+using std::cout;
+using std::streambuf;
 
 const char* const default_switch_error_c = "Error: reached default in switch statement!";
 const char* const empty_map_space_c = ". ";
+
+// Sends everything written to cout to another streambuf for as long as it exists
+Cout_redirect::Cout_redirect(streambuf* buffer) : saved_buffer(cout.rdbuf(buffer)) { }
+
+Cout_redirect::~Cout_redirect() {
+    cout.rdbuf(saved_buffer);
+}
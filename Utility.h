@@ -1,6 +1,7 @@
 #ifndef UTILITIES_H
 #define UTILITIES_H
 #include <exception>
+#include <streambuf>
 struct Point;
 
 class Error : public std::exception {
@@ -12,6 +13,26 @@ private:
 	const char* msg;
 };
 
+// A streambuf that discards everything written to it
+class Null_streambuf : public std::streambuf {
+protected:
+    int overflow(int c) override
+        {return traits_type::not_eof(c);}
+    std::streamsize xsputn(const char*, std::streamsize count) override
+        {return count;}
+};
+
+// Sends everything written to cout to another streambuf for as long as it exists
+class Cout_redirect {
+public:
+    Cout_redirect(std::streambuf* buffer);
+    ~Cout_redirect();
+    Cout_redirect(Cout_redirect& other)=delete;
+    Cout_redirect& operator=(Cout_redirect& rhs)=delete;
+private:
+    std::streambuf* saved_buffer;
+};
+
 // Error message for reaching 'default' in switch statements
 extern const char* const default_switch_error_c;
 extern const char* const empty_map_space_c;
@@ -0,0 +1,22 @@
+#include "View.h"
+#include <vector>
+using std::vector;
+
+// Apply a batch of updates in order, by default through the functions above
+void View::apply_updates(const vector<View_update>& updates) {
+    for(const View_update& update : updates) {
+        if(update.fields & (View_update::GONE | View_update::LEFT)) {
+            update_remove(update.id);
+            continue;
+        }
+        if(update.fields & View_update::LOCATION) {
+            update_location(update.id, update.location);
+        }
+        if(update.fields & View_update::FUEL) {
+            update_fuel(update.id, update.fuel);
+        }
+        if(update.fields & View_update::COURSE_AND_SPEED) {
+            update_course_and_speed(update.id, update.course, update.speed);
+        }
+    }
+}
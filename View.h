@@ -3,27 +3,80 @@ The View class encapsulates the data and functions needed to generate the map
 display, and control its properties. It has a "memory" for the names and locations
 of the to-be-plotted objects.
 
+Objects are identified by the IDs interned for their names (see Name_registry);
+a View looks up a name only to print it.
+
 Usage: 
-1. Call the update_location function with the name and position of each object
+1. Call the update_location function with the ID and position of each object
 to be plotted. If the object is not already in the View's memory, it will be added
 along with its location. If it is already present, its location will be set to the 
 supplied location. If a single object changes location, its location can be separately
 updated with a call to update_location. 
 
-2. Call the update_remove function with the name of any object that should
+2. Call the update_remove function with the ID of any object that should
 no longer be plotted. This must be done *after* any call to update_location that
-has the same object name since update_location will add any object name supplied.
+has the same object ID since update_location will add any object ID supplied.
+
+3. Call the capture_frame function to copy what the View shows now, and draw the
+frame to print out the map. Since a frame needs nothing else, it may be drawn later
+and on another thread (see Render_thread.h) while the View goes on being updated.
 
-3. Call the draw function to print out the map.
+The Model does not make these calls one at a time. It gathers the changes made
+during a tick, at most one View_update per object, and hands each View the whole
+batch with apply_updates. By default apply_updates makes the individual calls;
+a View may instead override it to work through the batch directly.
+
+A View that only shows part of the world says so with get_interest, and the Model
+then sends it only the updates for objects in that part. When an object comes into
+a region its whole state is sent, marked ENTERED; when it moves out, the View gets
+a LEFT update, which by default is handled like a removal.
 
 4. As needed, change the origin, scale, or displayed size of the map
 with the appropriate functions. Since the view "remembers" the previously updated
-information, the draw function will print out a map showing the previous objects
-using the new settings.
+information, the next frame will show the previous objects using the new settings.
  */
 #ifndef VIEW_H
 #define VIEW_H
 #include "Geometry.h"
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+// The changes to one object's state in a batch of updates for the Views
+struct View_update {
+    // fields that have changed; GONE and LEFT updates have no other fields
+    enum Field_e : unsigned char { LOCATION = 1, FUEL = 2, COURSE_AND_SPEED = 4, GONE = 8,
+                                   ENTERED = 16, LEFT = 32 };
+
+    int id;
+    unsigned char fields;
+    Point location;
+    double fuel;
+    double course;
+    double speed;
+};
+
+// The part of the world a View wants updates for
+struct View_interest {
+    enum class Kind_e { ALL, SHIPS_ONLY, RADIUS, BOX };
+
+    Kind_e kind;
+    // RADIUS: objects within radius of the object tracked_id, itself included
+    int tracked_id;
+    double radius;
+    // BOX: objects inside the box, edges included
+    Point lower_left;
+    Point upper_right;
+};
+
+// What a View shows at one moment, copied out of the View so that it can be drawn
+// at any later time, on any thread
+class View_frame {
+public:
+    virtual ~View_frame() {}
+    // print out the map
+    virtual void draw(std::ostream& os) const = 0;
+};
 
 class View {
 public:
@@ -34,26 +87,34 @@ public:
     View& operator=(View& rhs)=delete;
     View& operator=(View&& rhs)=delete;
     
-    // prints out the current map
-    virtual void draw() = 0;
+    // copy what the View shows now into a frame to be drawn
+    virtual std::unique_ptr<View_frame> capture_frame() = 0;
     
-    // Remove the name and its location; no error if the name is not present.
-    virtual void update_remove(const std::string& name_) = 0;
+    // Remove the object and its location; no error if the object is not present.
+    virtual void update_remove(int id) = 0;
     
-    // Update the Sim_object in the View with 'name' == name
-    virtual void update_location(const std::string& name, Point location) = 0;
+    // Update the location of the Sim_object whose ID is id
+    virtual void update_location(int id, Point location) = 0;
     
     // *** Fat Interface *** //
     // Default behavior is to do nothing //
     
     // Update ship fuel
-    virtual void update_fuel(const std::string& name, double fuel_) { };
+    virtual void update_fuel(int id, double fuel_) { };
     
     // Update ship heading
-    virtual void update_heading(const std::string& name_, double heading_) { };
+    virtual void update_heading(int id, double heading_) { };
     
     // Update ship speed
-    virtual void update_course_and_speed(const std::string& name, double course_, double speed_) { };
+    virtual void update_course_and_speed(int id, double course_, double speed_) { };
+
+    // Apply a batch of updates in order, by default through the functions above
+    virtual void apply_updates(const std::vector<View_update>& updates);
+
+    // The part of the world to send updates for; by default all of it.
+    // It is asked for each time updates are sent, so it may change.
+    virtual View_interest get_interest() const
+        {return View_interest{View_interest::Kind_e::ALL, -1, 0., Point(), Point()};}
 };
 
 #endif
\ No newline at end of file
@@ -1,73 +1,134 @@
 #include "Views.h"
 #include "Model.h"
+#include "Name_registry.h"
 #include "Navigation.h"
+#include "Sim_object.h"
 #include "Utility.h"
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
-using std::cout;
 using std::endl;
 using std::fill;
 using std::for_each;
-using std::map;
+using std::function;
+using std::move;
+using std::ostream;
 using std::setw;
 using std::pair;
 using std::shared_ptr;
 using std::string;
+using std::unique_ptr;
 using std::vector;
 
 const int sailng_data_set_width_c = 10;
 const int size_default_c = 25;
 const double scale_default_c = 2;
 const Point origin_default_c(-10, -10);
+// objects farther than this from ownship are not shown in a BridgeView
+const double bridge_view_range_c = 20.;
+// a BridgeView is sent updates for objects this close to ownship, a little more
+// than its range so that every object it may draw is known to it
+const double bridge_view_interest_radius_c = bridge_view_range_c + 1.;
+
+// The heading of a map with these settings, listing the objects outside of it
+static function<void(ostream&)> display_heading(int size, double scale, Point origin,
+                                                vector<string> outside_names) {
+    return [size, scale, origin, outside_names = move(outside_names)](ostream& os) {
+        os << "Display size: " << size << ", scale: " << scale << ", origin: " << origin << endl;
+        for(size_t i = 0; i < outside_names.size(); ++i) {
+            os << (i == 0 ? "" : ", ") << outside_names[i];
+        }
+        if(!outside_names.empty()) {
+            os << " outside the map" << endl;
+        }
+    };
+}
 
 // ************************************** //
 // ***** SailingView Implementation ***** //
 // ************************************** //
-void SailingView::draw()  {
-    cout << "----- Sailing Data -----" << endl;
-    cout << setw(sailng_data_set_width_c) << "Ship" << setw(sailng_data_set_width_c)
+// The frame of a SailingView: one row per Ship, in order of name
+struct Sailing_view_frame : public View_frame {
+    struct Row {
+        string name;
+        double fuel;
+        double course;
+        double speed;
+    };
+    vector<Row> rows;
+
+    void draw(ostream& os) const override;
+};
+
+void Sailing_view_frame::draw(ostream& os) const {
+    os << "----- Sailing Data -----" << endl;
+    os << setw(sailng_data_set_width_c) << "Ship" << setw(sailng_data_set_width_c)
     << "Fuel" << setw(sailng_data_set_width_c) << "Course"
     << setw(sailng_data_set_width_c) << "Speed" << endl;
-    for_each(ship_sailing_data.begin(), ship_sailing_data.end(),
-             [](const pair<string, SailingViewInfo>& name_sail_data_pair) {
-                 cout << setw(sailng_data_set_width_c)
-                    << name_sail_data_pair.first <<         setw(sailng_data_set_width_c)
-                    << name_sail_data_pair.second.fuel <<   setw(sailng_data_set_width_c)
-                    << name_sail_data_pair.second.course << setw(sailng_data_set_width_c)
-                    << name_sail_data_pair.second.speed <<  endl;
-             });
-}
-
-// Update the Sim_object in the View with 'name' == name
-void SailingView::update_location(const string& name, Point location) {
-    if(Model::get_instance().is_ship_present(name) && ship_sailing_data.find(name) == ship_sailing_data.end()) {
-        SailingViewInfo sail_data; // remove
-        ship_sailing_data[name] = sail_data;
+    for(const Row& row : rows) {
+        os << setw(sailng_data_set_width_c)
+            << row.name << setw(sailng_data_set_width_c)
+            << row.fuel <<     setw(sailng_data_set_width_c)
+            << row.course <<   setw(sailng_data_set_width_c)
+            << row.speed <<    endl;
     }
+}
 
+// copy the sailing data shown now into a frame to be drawn
+unique_ptr<View_frame> SailingView::capture_frame() {
+    unique_ptr<Sailing_view_frame> frame(new Sailing_view_frame);
+    const Name_registry& names = Name_registry::get_instance();
+    ship_sailing_data.for_each_in_name_order(
+             [&names, &frame](int id, const SailingViewInfo& sail_data) {
+                 frame->rows.push_back(Sailing_view_frame::Row{names.get_name(id),
+                     sail_data.fuel, sail_data.course, sail_data.speed});
+             });
+    return frame;
 }
 
 // Update ship fuel
-void SailingView::update_fuel(const string& name, double fuel_) {
-    ship_sailing_data[name].fuel = fuel_;
+void SailingView::update_fuel(int id, double fuel_) {
+    ship_sailing_data[id].fuel = fuel_;
 }
 
 // Update ship speed
-void SailingView::update_course_and_speed(const string& name, double course_, double speed_) {
-    SailingViewInfo& sailing_data = ship_sailing_data[name];
+void SailingView::update_course_and_speed(int id, double course_, double speed_) {
+    SailingViewInfo& sailing_data = ship_sailing_data[id];
     sailing_data.course = course_;
     sailing_data.speed = speed_;
 }
 
 // Update ship afloat state
-void SailingView::update_remove(const string& name) {
-    ship_sailing_data.erase(name);
+void SailingView::update_remove(int id) {
+    ship_sailing_data.erase(id);
+}
+
+// Only Ships are shown
+View_interest SailingView::get_interest() const {
+    return View_interest{View_interest::Kind_e::SHIPS_ONLY, -1, 0., Point(), Point()};
+}
+
+// Apply a batch of updates in order
+void SailingView::apply_updates(const vector<View_update>& updates) {
+    for(const View_update& update : updates) {
+        if(update.fields & (View_update::GONE | View_update::LEFT)) {
+            SailingView::update_remove(update.id);
+            continue;
+        }
+        if(update.fields & View_update::FUEL) {
+            SailingView::update_fuel(update.id, update.fuel);
+        }
+        if(update.fields & View_update::COURSE_AND_SPEED) {
+            SailingView::update_course_and_speed(update.id, update.course, update.speed);
+        }
+    }
 }
 
 
@@ -76,53 +137,85 @@ void SailingView::update_remove(const string& name) {
 // ************************************** //
 
 
-void GraphicView::draw() {
+// The frame of a GraphicView: its heading, its settings, and the two-letter label
+// of each object to plot with the object's x, y subscripts
+struct Graphic_view_frame : public View_frame {
+    function<void(ostream&)> print_map_heading;
+    int size;
+    double scale;
+    Point origin;
+    bool draw_y_coordinates;
+    int second_dimension_size;
+    string empty_space;
+    string crowded_space;
+    vector<pair<string, Point>> labels_to_plot;
+
+    void draw(ostream& os) const override;
+};
+
+void Graphic_view_frame::draw(ostream& os) const {
     
-    print_map_heading();
+    print_map_heading(os);
     
     vector<vector<string>> matrix;
-    for(int i=0; i<get_second_dimension_size(); ++i) { // get_size() is inlined
-        matrix.push_back(vector<string>(get_first_dimension_size(), get_empty_space()));
+    for(int i=0; i<second_dimension_size; ++i) {
+        matrix.push_back(vector<string>(size, empty_space));
     }
     
-    map<string, Point> points_to_plot = get_draw_info();
-    
-    for(const auto& name_point_pair : points_to_plot) {
-        matrix[get_second_dimension_size()-name_point_pair.second.y-1][name_point_pair.second.x] =
-        (matrix[get_second_dimension_size()-name_point_pair.second.y-1][name_point_pair.second.x] == get_empty_space()) ?
-        name_point_pair.first.substr(0, 2) : get_crowded_space();
+    for(const auto& label_point_pair : labels_to_plot) {
+        string& cell = matrix[second_dimension_size-label_point_pair.second.y-1][label_point_pair.second.x];
+        cell = (cell == empty_space) ? label_point_pair.first : crowded_space;
     }
 
     // Output our Matrix
     int i = 0, y = ( (size-1) * scale) + origin.y;
     for(const auto& row : matrix) {
-        cout << setw(5);
+        os << setw(5);
         if(draw_y_coordinates && !((size-i-1) % 3)) { // Output Y-Column subscripts
-            cout.precision(0);
-            cout << setw(4) << y-i * scale;
+            os.precision(0);
+            os << setw(4) << y-i * scale;
         }
-        cout  << " ";
+        os  << " ";
         ++i;
         for(const auto& cell : row) { // TODO - ostream iterator
-            cout << cell;
+            os << cell;
         }
-        cout << endl;
+        os << endl;
     }
     
-    cout << setw(6);
+    os << setw(6);
     for(int i = 0; i < size; ++i) {
         if(!(i % 3)) {
-            cout.precision(0);
-            cout << origin.x + i*scale; // Output X-Row subscripts
+            os.precision(0);
+            os << origin.x + i*scale; // Output X-Row subscripts
         }
-        cout << setw(6);
+        os << setw(6);
     }
-    cout << endl;
-    cout.precision(2); // reset precision
+    os << endl;
+    os.precision(2); // reset precision
     
     
 }
 
+// copy the map shown now into a frame to be drawn
+unique_ptr<View_frame> GraphicView::capture_frame() {
+    unique_ptr<Graphic_view_frame> frame(new Graphic_view_frame);
+    frame->print_map_heading = capture_map_heading();
+    frame->size = size;
+    frame->scale = scale;
+    frame->origin = origin;
+    frame->draw_y_coordinates = draw_y_coordinates;
+    frame->second_dimension_size = get_second_dimension_size();
+    frame->empty_space = get_empty_space();
+    frame->crowded_space = get_crowded_space();
+    const Name_registry& names = Name_registry::get_instance();
+    for(const auto& id_point_pair : get_draw_info()) {
+        frame->labels_to_plot.push_back(pair<string, Point>(
+            names.get_name(id_point_pair.first).substr(0, 2), id_point_pair.second));
+    }
+    return frame;
+}
+
 // Protected Functions
 GraphicView::GraphicView(int size_, double scale_, Point origin_, bool draw_y) : View(),
     size(size_), scale(scale_), origin(origin_), draw_y_coordinates(draw_y) {}
@@ -159,29 +252,40 @@ bool GraphicView::get_subscripts(int &ix, int &iy, Point location)
 // default constructor sets the default size, scale, and origin, outputs constructor message
 MapView::MapView() : GraphicView(size_default_c, scale_default_c, origin_default_c, true)  { }
 
-// Get x, y coordinates and name/points to map
-map<string, Point> MapView::get_draw_info() {
-    map<string, Point> points_to_plot;
+// Get the ID and x, y subscripts of each object to map
+vector<pair<int, Point>> MapView::get_draw_info() {
+    vector<pair<int, Point>> points_to_plot;
     
     // Mark the Matrix with Object Locations
-    for(const auto pair : object_locations) {
+    object_locations.for_each([this, &points_to_plot](int id, Point location) {
         int x, y;
-        if(GraphicView::get_subscripts(x, y, pair.second)) {
-            points_to_plot[pair.first] = Point(x, y);
+        if(GraphicView::get_subscripts(x, y, location)) {
+            points_to_plot.push_back(pair<int, Point>(id, Point(x, y)));
         }
-    }
+    });
     return points_to_plot;
 }
 
-// Save the supplied name and location for future use in a draw() call
-// If the name is already present,the new location replaces the previous one.
-void MapView::update_location(const string& name_, Point location) {
-    object_locations[name_] = location;
+// Save the supplied ID and location for future use in a draw() call
+// If the ID is already present,the new location replaces the previous one.
+void MapView::update_location(int id, Point location) {
+    object_locations[id] = location;
+}
+
+// Remove the object and its location; no error if the object is not present.
+void MapView::update_remove(int id) {
+    object_locations.erase(id);
 }
 
-// Remove the name and its location; no error if the name is not present.
-void MapView::update_remove(const string& name) {
-    object_locations.erase(name);
+// Apply a batch of updates in order
+void MapView::apply_updates(const vector<View_update>& updates) {
+    for(const View_update& update : updates) {
+        if(update.fields & (View_update::GONE | View_update::LEFT)) {
+            MapView::update_remove(update.id);
+        } else if(update.fields & View_update::LOCATION) {
+            MapView::update_location(update.id, update.location);
+        }
+    }
 }
 
 void MapView::set_size(int size_) {
@@ -217,23 +321,17 @@ void MapView::clear() {
     object_locations.clear();
 }
 
-void MapView::print_map_heading() {
-    cout << "Display size: " << get_first_dimension_size() << ", scale: " << get_scale() << ", origin: " << get_origin() << endl;
-    bool first_outside = false; // Bool to track if we have an Object outside of the Map
-    int x, y;
-    for(const auto pair : object_locations) {
-        if(!GraphicView::get_subscripts(x, y, pair.second)) {
-            if(!first_outside) {
-                first_outside = true;
-                cout << pair.first;
-            } else {
-                cout << ", " << pair.first;
-            }
+// Copy the top of the map, to be printed when the frame is drawn
+function<void(ostream&)> MapView::capture_map_heading() {
+    vector<string> outside_names;
+    const Name_registry& names = Name_registry::get_instance();
+    object_locations.for_each_in_name_order([this, &outside_names, &names](int id, Point location) {
+        int x, y;
+        if(!GraphicView::get_subscripts(x, y, location)) {
+            outside_names.push_back(names.get_name(id));
         }
-    }
-    if(first_outside) {
-        cout << " outside the map" << endl;
-    }
+    });
+    return display_heading(get_first_dimension_size(), get_scale(), get_origin(), move(outside_names));
 }
 
 // ************************************* //
@@ -241,18 +339,26 @@ void MapView::print_map_heading() {
 // ************************************* //
 
 // default constructor sets the default size, scale, and origin, outputs constructor message
-BridgeView::BridgeView(const string& name_) : GraphicView(19, 10, -90.0, false),name(name_), is_afloat(true) { }
+BridgeView::BridgeView(const string& name_) : GraphicView(19, 10, -90.0, false),name(name_),
+    ownship_id(Name_registry::get_instance().intern(name_)), is_afloat(true) { }
 
 // prints out the current map
-map<string, Point> BridgeView::get_draw_info() {
-    map<string, Point> points_to_plot;
+vector<pair<int, Point>> BridgeView::get_draw_info() {
+    vector<pair<int, Point>> points_to_plot;
     if(is_afloat) {
-        Point ownship_location = object_locations.find(name)->second;
-        for(const pair<string, Point>& name_position_pair : object_locations) {
-            if(name_position_pair.first != name) {
-                Point othership_location = name_position_pair.second;
+        Point ownship_location = *object_locations.find(ownship_id);
+        // only objects the Model finds in range need a closer look
+        for(const auto& object_ptr : Model::get_instance().objects_within(ownship_location,
+                                                                          bridge_view_range_c + .01)) {
+            int id = object_ptr->get_id();
+            const Point* position_ptr = object_locations.find(id);
+            if(!position_ptr) {
+                continue;
+            }
+            if(id != ownship_id) {
+                Point othership_location = *position_ptr;
                 Compass_position compass_pos(ownship_location, othership_location);
-                if(compass_pos.range > 20 || compass_pos.range < 0.005) {
+                if(compass_pos.range > bridge_view_range_c || compass_pos.range < 0.005) {
                     continue;
                 }
                 double bow_angle = compass_pos.bearing - heading;
@@ -266,7 +372,7 @@ map<string, Point> BridgeView::get_draw_info() {
                 }
                 int x, y;
                 if(get_subscripts(x, y, Point(bow_angle, 0))) {
-                    points_to_plot[name_position_pair.first] = Point(x, y);
+                    points_to_plot.push_back(pair<int, Point>(id, Point(x, y)));
                 }
             }
         }
@@ -274,38 +380,69 @@ map<string, Point> BridgeView::get_draw_info() {
     return points_to_plot;
 }
 
-void BridgeView::print_map_heading() {
-    cout << "Bridge view from " << name;
-    if(is_afloat) {
-        cout << " position " << ownship_location << " heading " << heading;
-    } else {
-        cout << " sunk at " << ownship_location;
-    }
-    cout << endl;
+// Copy the top of the map, to be printed when the frame is drawn
+function<void(ostream&)> BridgeView::capture_map_heading() {
+    return [name = name, is_afloat = is_afloat, ownship_location = ownship_location,
+            heading = heading](ostream& os) {
+        os << "Bridge view from " << name;
+        if(is_afloat) {
+            os << " position " << ownship_location << " heading " << heading;
+        } else {
+            os << " sunk at " << ownship_location;
+        }
+        os << endl;
+    };
 }
 
 // Update the location of a name in the View
-void BridgeView::update_location(const string& name_, Point location) {
-    object_locations[name_] = location;
-    if(name == name_) {
+void BridgeView::update_location(int id, Point location) {
+    object_locations[id] = location;
+    if(id == ownship_id) {
         ownship_location = location;
+        is_afloat = true;
     }
 }
 
-void BridgeView::update_remove(const string& name_) {
-    object_locations.erase(name_);
-    if(name == name_) {
+void BridgeView::update_remove(int id) {
+    object_locations.erase(id);
+    if(id == ownship_id) {
         is_afloat = false;
     }
 }
 
 // Update ship heading
-void BridgeView::update_course_and_speed(const string& name_, double course_, double) {
-    if(name == name_) {
+void BridgeView::update_course_and_speed(int id, double course_, double) {
+    if(id == ownship_id) {
         heading = course_;
     }
 }
 
+// Only objects near the ownship are shown
+View_interest BridgeView::get_interest() const {
+    return View_interest{View_interest::Kind_e::RADIUS, ownship_id, bridge_view_interest_radius_c,
+                         Point(), Point()};
+}
+
+// Apply a batch of updates in order
+void BridgeView::apply_updates(const vector<View_update>& updates) {
+    for(const View_update& update : updates) {
+        if(update.fields & View_update::GONE) {
+            BridgeView::update_remove(update.id);
+            continue;
+        }
+        if(update.fields & View_update::LEFT) {
+            object_locations.erase(update.id);
+            continue;
+        }
+        if(update.fields & View_update::LOCATION) {
+            BridgeView::update_location(update.id, update.location);
+        }
+        if(update.fields & View_update::COURSE_AND_SPEED) {
+            BridgeView::update_course_and_speed(update.id, update.course, update.speed);
+        }
+    }
+}
+
 // Get empty space from derived class
 const char* const BridgeView::get_empty_space() {
     return (is_afloat) ? empty_map_space_c : "w-";
@@ -316,49 +453,54 @@ const char* const BridgeView::get_empty_space() {
 // ************************************* //
 
 ObjectView::ObjectView(const string& name_) : GraphicView(size_default_c, scale_default_c, origin_default_c, true),
-    name(name_) {}
+    name(name_), centered_id(Name_registry::get_instance().intern(name_)) {}
 
 // Update the location of a name in the View
-void ObjectView::update_location(const string& name_, Point location) {
-    object_locations[name_] = location;
-    if(name == name_) {
+void ObjectView::update_location(int id, Point location) {
+    object_locations[id] = location;
+    if(id == centered_id) {
         set_origin(Point(location.x - get_first_dimension_size(), location.y - get_first_dimension_size()));
     }
 }
     
 // update a removed Ship
-void ObjectView::update_remove(const string& name_) {
-    object_locations.erase(name_);
+void ObjectView::update_remove(int id) {
+    object_locations.erase(id);
+}
+
+// Apply a batch of updates in order
+void ObjectView::apply_updates(const vector<View_update>& updates) {
+    for(const View_update& update : updates) {
+        if(update.fields & (View_update::GONE | View_update::LEFT)) {
+            ObjectView::update_remove(update.id);
+        } else if(update.fields & View_update::LOCATION) {
+            ObjectView::update_location(update.id, update.location);
+        }
+    }
 }
     
-// Get x, y coordinates and name/points to map
-map<string, Point> ObjectView::get_draw_info() {
-    map<string, Point> points_to_plot;
+// Get the ID and x, y subscripts of each object to map
+vector<pair<int, Point>> ObjectView::get_draw_info() {
+    vector<pair<int, Point>> points_to_plot;
     // Mark the Matrix with Object Locations
-    for(const auto& pair : object_locations) {
+    object_locations.for_each([this, &points_to_plot](int id, Point location) {
         int x, y;
-        if(GraphicView::get_subscripts(x, y, pair.second)) {
-            points_to_plot[pair.first] = Point(x, y);
+        if(GraphicView::get_subscripts(x, y, location)) {
+            points_to_plot.push_back(pair<int, Point>(id, Point(x, y)));
         }
-    }
+    });
     return points_to_plot;
 }
 
-void ObjectView::print_map_heading() {
-    cout << "Display size: " << get_first_dimension_size() << ", scale: " << get_scale() << ", origin: " << get_origin() << endl;
-    bool first_outside = false; // Bool to track if we have an Object outside of the Map
-    int x, y;
-    for(const auto& pair : object_locations) {
-        if(!GraphicView::get_subscripts(x, y, pair.second)) {
-            if(!first_outside) {
-                first_outside = true;
-                cout << pair.first;
-            } else {
-                cout << ", " << pair.first;
-            }
+// Copy the top of the map, to be printed when the frame is drawn
+function<void(ostream&)> ObjectView::capture_map_heading() {
+    vector<string> outside_names;
+    const Name_registry& names = Name_registry::get_instance();
+    object_locations.for_each_in_name_order([this, &outside_names, &names](int id, Point location) {
+        int x, y;
+        if(!GraphicView::get_subscripts(x, y, location)) {
+            outside_names.push_back(names.get_name(id));
         }
-    }
-    if(first_outside) {
-        cout << " outside the map" << endl;
-    }
+    });
+    return display_heading(get_first_dimension_size(), get_scale(), get_origin(), move(outside_names));
 }
\ No newline at end of file
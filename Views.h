@@ -2,26 +2,37 @@
 #define VIEWS_H
 #include "View.h"
 #include "Geometry.h"
+#include "Id_map.h"
 #include "Utility.h"
-#include <map>
+#include <functional>
+#include <iosfwd>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 class SailingView : public View {
 public:
-    // prints out the current map
-    void draw() override;
+    // copy the sailing data shown now into a frame to be drawn
+    std::unique_ptr<View_frame> capture_frame() override;
     
     // Update ship fuel
-    void update_fuel(const std::string& name, double fuel_) override;
+    void update_fuel(int id, double fuel_) override;
     
-    // Update the Sim_object in the View with 'name' == name
-    void update_location(const std::string& name_, Point location) override;
+    // Only Ships are shown, and they are added by their fuel and course reports
+    void update_location(int, Point) override { }
     
     // Remove a Ship from the View
-    void update_remove(const std::string& name) override;
+    void update_remove(int id) override;
     
     // Update ship speed
-    void update_course_and_speed(const std::string& name, double course_, double speed_) override;
+    void update_course_and_speed(int id, double course_, double speed_) override;
+    
+    // Apply a batch of updates in order
+    void apply_updates(const std::vector<View_update>& updates) override;
+    
+    // Only Ships are shown
+    View_interest get_interest() const override;
 
 private:
     // Struct containing all data needed for SailingView
@@ -31,7 +42,7 @@ private:
         double speed;
     };
     
-    std::map<std::string, SailingViewInfo> ship_sailing_data;
+    Id_map<SailingViewInfo> ship_sailing_data;
     
 };
 
@@ -39,7 +50,8 @@ class GraphicView : public View {
 public:
     GraphicView(int size_, double scale_, Point origin, bool draw_y);
     
-    void draw() override;
+    // copy the map shown now into a frame to be drawn
+    std::unique_ptr<View_frame> capture_frame() override;
     
 protected:
     // Calculate subscripts of Sim_object on the map
@@ -57,10 +69,10 @@ private:
     Point origin;		// coordinates of the lower-left-hand corner
     bool draw_y_coordinates;
     // Template Pattern helpers
-    // Print the top of the map
-    virtual void print_map_heading() = 0;
-    // Get x, y coordinates and name/points to map
-    virtual std::map<std::string, Point> get_draw_info() = 0;
+    // Copy the top of the map, to be printed when the frame is drawn
+    virtual std::function<void(std::ostream&)> capture_map_heading() = 0;
+    // Get the ID and x, y subscripts of each object to map
+    virtual std::vector<std::pair<int, Point>> get_draw_info() = 0;
     // Get empty space from derived class
     virtual const char* const get_empty_space() = 0;
     // Get space with multiple ships from derived class
@@ -74,11 +86,14 @@ public:
     // default constructor sets the default size, scale, and origin
     MapView();
     
-    // Update the location of a name in the View
-    void update_location(const std::string& name_, Point location) override;
+    // Update the location of an object in the View
+    void update_location(int id, Point location) override;
+    
+    // Remove the object and its location; no error if the object is not present.
+    void update_remove(int id) override;
     
-    // Remove the name and its location; no error if the name is not present.
-    void update_remove(const std::string& name) override;
+    // Apply a batch of updates in order
+    void apply_updates(const std::vector<View_update>& updates) override;
     
     // Discard the saved information - drawing will show only a empty pattern
     void clear();
@@ -95,10 +110,10 @@ public:
     void set_defaults();
     
 private:
-    // Print the top of the map
-    void print_map_heading() override;
-    // Get x, y coordinates and name/points to map
-    std::map<std::string, Point> get_draw_info() override;
+    // Copy the top of the map, to be printed when the frame is drawn
+    std::function<void(std::ostream&)> capture_map_heading() override;
+    // Get the ID and x, y subscripts of each object to map
+    std::vector<std::pair<int, Point>> get_draw_info() override;
     // Get empty space from derived class
     const char* const get_empty_space() override { return empty_map_space_c; }
     // Get space with multiple ships from derived class
@@ -106,7 +121,7 @@ private:
     // Get the second dimension of the map
     int get_second_dimension_size() override { return get_first_dimension_size(); }
     // Locations of all Sim_objects in the simulation
-    std::map<std::string, Point> object_locations;
+    Id_map<Point> object_locations;
     
 };
 
@@ -114,21 +129,27 @@ class BridgeView : public GraphicView {
 public:
     BridgeView(const std::string& name_);
     
-    // Update the location of a name in the View
-    void update_location(const std::string& name_, Point location) override;
+    // Update the location of an object in the View
+    void update_location(int id, Point location) override;
     
     // update a removed Ship
-    void update_remove(const std::string& name_) override;
+    void update_remove(int id) override;
     
     // Update ship heading
-    void update_course_and_speed(const std::string& name_, double course_, double) override;
+    void update_course_and_speed(int id, double course_, double) override;
+    
+    // Apply a batch of updates in order
+    void apply_updates(const std::vector<View_update>& updates) override;
+    
+    // Only objects near the ownship are shown
+    View_interest get_interest() const override;
 private:
-    // Print the top of the map
-    void print_map_heading() override;
-    // Get x, y coordinates and name/points to map
-    std::map<std::string, Point> get_draw_info() override;
+    // Copy the top of the map, to be printed when the frame is drawn
+    std::function<void(std::ostream&)> capture_map_heading() override;
+    // Get the ID and x, y subscripts of each object to map
+    std::vector<std::pair<int, Point>> get_draw_info() override;
     // Locations of all Sim_objects in the simulation
-    std::map<std::string, Point> object_locations;
+    Id_map<Point> object_locations;
     // Get empty space from derived class
     const char* const get_empty_space() override;
     // Get space with multiple ships from derived class
@@ -136,6 +157,7 @@ private:
     // Get the second dimension of the map
     int get_second_dimension_size() override { return 3; }
     std::string name;
+    int ownship_id;
     bool is_afloat;
     Point ownship_location;
     double heading;
@@ -145,17 +167,20 @@ class ObjectView : public GraphicView {
 public:
     ObjectView(const std::string& name_);
     
-    // Update the location of a name in the View
-    void update_location(const std::string& name_, Point location) override;
+    // Update the location of an object in the View
+    void update_location(int id, Point location) override;
     
     // update a removed Ship
-    void update_remove(const std::string& name_) override;
+    void update_remove(int id) override;
+    
+    // Apply a batch of updates in order
+    void apply_updates(const std::vector<View_update>& updates) override;
     
 private:
-    // Print the top of the map
-    void print_map_heading() override;
-    // Get x, y coordinates and name/points to map
-    std::map<std::string, Point> get_draw_info() override;
+    // Copy the top of the map, to be printed when the frame is drawn
+    std::function<void(std::ostream&)> capture_map_heading() override;
+    // Get the ID and x, y subscripts of each object to map
+    std::vector<std::pair<int, Point>> get_draw_info() override;
     // Get empty space from derived class
     const char* const get_empty_space() override { return empty_map_space_c; }
     // Get space with multiple ships from derived class
@@ -163,8 +188,9 @@ private:
     // Get the second dimension of the map
     int get_second_dimension_size() override { return get_first_dimension_size(); }
     // Locations of all Sim_objects in the simulation
-    std::map<std::string, Point> object_locations;
+    Id_map<Point> object_locations;
     std::string name;
+    int centered_id;
 };
 
 #endif
\ No newline at end of file
@@ -1,12 +1,15 @@
 #include "Warship.h"
+#include "Model.h"
+#include "Snapshot.h"
 #include "Utility.h"
+#include "Event_log.h"
 #include <iostream>
 #include <memory>
 using std::cout;
 using std::endl;
+using std::ostream;
 using std::string;
 using std::shared_ptr;
-using std::weak_ptr;
 
 // initialize, then output constructor message
 Warship::Warship(const string& name_, Point position_, double fuel_capacity_,
@@ -14,18 +17,19 @@ Warship::Warship(const string& name_, Point position_, double fuel_capacity_,
     int firepower_, double maximum_range_) :
     Ship(name_, position_, fuel_capacity_, maximum_speed_, fuel_consumption_, resistance_),
     firepower(firepower_), maximum_range(maximum_range_),
-    attack_state(Attack_State_e::NOTATTACKING) { }
+    attack_state(Attack_State_e::NOTATTACKING), target(Ship_handle{-1, 0}) { }
 
 // perform warship-specific behavior
 void Warship::update() {
     Ship::update();
     if(is_attacking()) {
-        shared_ptr<Ship> target_now = target.lock();
+        Ship* target_now = get_target();
         if(target_now) {
             if(!is_afloat() || !target_now->is_afloat()) {
                 stop_attack();
             } else {
-                cout << get_name() << " is attacking" << endl;
+                if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::DETAIL))
+                    *log << get_name() << " is attacking" << '\n';
             }
         } else {
             stop_attack();
@@ -46,13 +50,15 @@ void Warship::attack(shared_ptr<Ship> target_ptr_) {
     if(target_ptr_ == shared_from_this()) {
         throw Error("Warship may not attack itself!");
     }
-    shared_ptr<Ship> target_now = target.lock();
-    if(target_ptr_ == target_now) {
+    if(target_ptr_.get() == get_target()) {
         throw Error("Already attacking this target!");
     }
-    target = target_ptr_;
+    target = target_ptr_->get_handle();
     attack_state = Attack_State_e::ATTACKING;
-    cout << get_name() << " will attack " << target_ptr_->get_name() << endl;
+    // a Warship told to attack by another Ship may be asleep
+    Model::get_instance().wake(shared_from_this());
+    if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::NOTICE))
+        *log << get_name() << " will attack " << target_ptr_->get_name() << '\n';
 }
 
 // will throw Error("Was not attacking!") if not Attacking
@@ -60,15 +66,16 @@ void Warship::stop_attack() {
     if(!is_attacking()) {
         throw Error("Was not attacking!");
     }
-    cout << get_name() << " stopping attack" << endl;
+    if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::NOTICE))
+        *log << get_name() << " stopping attack" << '\n';
     attack_state = Attack_State_e::NOTATTACKING;
-    target.reset();
+    target = Ship_handle{-1, 0};
 }
 
 void Warship::describe() const {
     Ship::describe();
     if(is_attacking()) {
-        shared_ptr<Ship> target_now = target.lock();
+        Ship* target_now = get_target();
         if(!target_now || !target_now->is_afloat()) {
             cout << "Attacking absent ship";
         } else {
@@ -79,15 +86,45 @@ void Warship::describe() const {
 }
 
 void Warship::respond_to_attack(shared_ptr<Tanker> tanker_ptr) {
-    cout << "In DD-Tanker!" << endl;
+    Model::get_instance().wake(shared_from_this());
+    if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::NOTICE))
+        *log << "In DD-Tanker!" << '\n';
 }
 
 void Warship::respond_to_attack(shared_ptr<Cruise_ship> cruise_ship_ptr) {
-    cout << "In DD-Cruise_ship!" << endl;
+    Model::get_instance().wake(shared_from_this());
+    if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::NOTICE))
+        *log << "In DD-Cruise_ship!" << '\n';
 }
 
 void Warship::respond_to_attack(shared_ptr<Cruiser> cruiser_ptr) {
-    cout << "In DD-Cruiser!" << endl;
+    Model::get_instance().wake(shared_from_this());
+    if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::NOTICE))
+        *log << "In DD-Cruiser!" << '\n';
+}
+
+// idle if the Ship is idle and not attacking
+bool Warship::is_idle() const {
+    return Ship::is_idle() && !is_attacking();
+}
+
+// no ticks can be skipped while attacking
+int Warship::ticks_until_event() const {
+    return is_attacking() ? 0 : Ship::ticks_until_event();
+}
+
+// add the attack state and target to the Ship's state
+void Warship::save_state(Snapshot_writer& writer) const {
+    Ship::save_state(writer);
+    writer.write_byte(static_cast<unsigned char>(attack_state));
+    writer.write_ship_ref(get_target());
+}
+
+void Warship::load_state(Snapshot_reader& reader) {
+    Ship::load_state(reader);
+    attack_state = static_cast<Attack_State_e>(reader.read_choice(static_cast<int>(Attack_State_e::NOTATTACKING) + 1));
+    shared_ptr<Ship> target_ptr = reader.read_ship_ref();
+    target = target_ptr ? target_ptr->get_handle() : Ship_handle{-1, 0};
 }
 
 // return true if this Warship is in the attacking state
@@ -97,18 +134,12 @@ bool Warship::is_attacking() const {
 
 // fire at the current target
 void Warship::fire_at_target() {
-    cout << get_name() << " fires" << endl;
-    shared_ptr<Ship> target_now = target.lock();
-    target_now->receive_hit(firepower, shared_from_this());
+    if(ostream* log = log_event(Event_category_e::COMBAT, Event_level_e::NOTICE))
+        *log << get_name() << " fires" << '\n';
+    Model::get_instance().fire(*this, *get_target(), firepower);
 }
 
 // is the current target in range?
 bool Warship::target_in_range() const {
-    shared_ptr<Ship> target_now = target.lock();
-    return cartesian_distance(get_location(), target_now->get_location()) <= maximum_range;
+    return cartesian_distance(get_location(), get_target()->get_location()) <= maximum_range;
 }
-
-// get the target
-shared_ptr<Ship> Warship::get_target() const {
-    return target.lock();
-}
\ No newline at end of file
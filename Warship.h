@@ -2,6 +2,7 @@
 A Warship is a ship with firepower and range member variables, and some services for
 protected classes to manage many of the details of warship behavior. This is an
 abstract base class, so concrete classes derived from Warship must be declared.
+The target is kept as a Ship_handle, which goes stale when the target sinks.
 */
 #ifndef WARSHIP_H
 #define WARSHIP_H
@@ -17,6 +18,14 @@ class Warship : public Ship {
 public:
 	// perform warship-specific behavior
 	void update() override;
+	// idle if the Ship is idle and not attacking
+	bool is_idle() const override;
+	// no ticks can be skipped while attacking
+	int ticks_until_event() const override;
+
+	// add the attack state and target to the Ship's state
+	void save_state(Snapshot_writer& writer) const override;
+	void load_state(Snapshot_reader& reader) override;
 
 	// Warships will act on an attack and stop_attack command
 
@@ -51,16 +60,18 @@ protected:
 	// is the current target in range?
 	bool target_in_range() const;
 
-	// get the target
-    std::shared_ptr<Ship> get_target() const;
+	// get the target, or nullptr if it has sunk
+    Ship* get_target() const
+        {return Ship_handle_table::get_instance().get(target);}
     
 private:
+    // NOTATTACKING must stay last; snapshots check states against it
     enum class Attack_State_e { ATTACKING, NOTATTACKING };
     
     int firepower;
     double maximum_range;
     Attack_State_e attack_state;
-    std::weak_ptr<Ship> target;
+    Ship_handle target;     // checked without locking, unlike a weak_ptr
 };
 
 #endif
@@ -1,20 +1,31 @@
 #include "Controller.h"
+#include "Event_log.h"
 #include <iostream>
 
 using namespace std;
 
-// The main function creates the Controller object, then tells it to run.
+// The main function creates the Controller object, then tells it to run, reading
+// commands from the script file named on the command line if there is one.
+// With "--serve <socket>", it serves clients of a Unix domain socket instead.
 
-int main ()
+int main (int argc, char* argv[])
 {
     // Set output to show two decimal places
     //	cout << fixed << setprecision(2) << endl;
     cout.setf(ios::fixed, ios::floatfield);
     cout.precision(2);
     
+    // the event log takes over cout before anything else does
+    Event_log::get_instance();
+    
     // create the Controller and go
     Controller controller;
     
-    controller.run();
+    if(argc > 2 && string(argv[1]) == "--serve")
+        controller.serve(argv[2]);
+    else if(argc > 1)
+        controller.run_script(argv[1]);
+    else
+        controller.run();
 }
 
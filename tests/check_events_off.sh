@@ -0,0 +1,31 @@
+#!/bin/sh
+# Regression check: turning console events off must not change the simulation.
+# A sleeping Cruiser that is attacked has to wake up and fire back, so the same
+# commands must leave every object in the same state with events on and off.
+# usage: check_events_off.sh <program>
+program=${1:?usage: check_events_off.sh <program>}
+
+commands='Xerxes attack Ajax
+go
+go
+go
+go
+Ajax course 90 5
+go
+status
+quit'
+
+# the output of the last command before quit
+final_status() {
+    printf 'events %s\n%s\n' "$1" "$commands" | "$program" |
+        awk 'BEGIN {RS = "Enter command: "} {previous = last; last = $0} END {printf "%s", previous}'
+}
+
+on=$(final_status on)
+off=$(final_status off)
+if [ -z "$on" ] || [ "$on" != "$off" ]; then
+    echo "FAIL: status differs with events off"
+    printf '%s\n--- events off ---\n%s\n' "$on" "$off"
+    exit 1
+fi
+echo "PASS: status is the same with events on and off"
@@ -0,0 +1,39 @@
+#!/bin/sh
+# Regression check: replaying a journal must reproduce the recorded run, even when
+# a command changes the simulation before it fails. "Cc position" is too fast for
+# a Cruise_ship, but it cancels the cruise before saying so.
+# usage: check_journal_replay.sh <program>
+program=${1:?usage: check_journal_replay.sh <program>}
+directory=$(mktemp -d) || exit 1
+trap 'rm -rf "$directory"' EXIT
+
+commands="create Cc Cruise_ship 0 0
+open_journal $directory/journal 5
+Cc destination Exxon 10
+go
+go
+Cc position 50 50 100
+go
+go
+go
+go
+go
+go
+go
+go
+close_journal
+status
+replay $directory/journal
+status
+quit"
+
+# compare the outputs of the two status commands, recorded and replayed
+if ! printf '%s\n' "$commands" | "$program" |
+    awk 'BEGIN {RS = "Enter command: "} {outputs[NR] = $0}
+         END {recorded = outputs[NR - 3]; replayed = outputs[NR - 1]
+              if(recorded != "" && recorded == replayed) exit 0
+              printf "%s\n--- replayed ---\n%s\n", recorded, replayed; exit 1}'; then
+    echo "FAIL: replayed journal differs from the recorded run"
+    exit 1
+fi
+echo "PASS: replayed journal matches the recorded run"
@@ -0,0 +1,88 @@
+#!/bin/sh
+# Regression check: a telemetry file must decode as the format in Telemetry.h says,
+# and a Ship that sinks and is replaced by a Ship of another type with the same name
+# between two ticks written must be recorded as gone and then new, with its new type.
+# Ajax sinks at time 3, and a Tanker named Ajax is created before the tick at time 4.
+# usage: check_telemetry.sh <program>
+program=${1:?usage: check_telemetry.sh <program>}
+directory=$(mktemp -d) || exit 1
+trap 'rm -rf "$directory"' EXIT
+
+commands="open_telemetry $directory/telemetry 2
+Xerxes attack Ajax
+go
+go
+go
+create Ajax Tanker 15 15
+go
+close_telemetry
+quit"
+
+printf '%s\n' "$commands" | "$program" > /dev/null
+
+# decode the file into a line per entry: time, kind, name, and type for NEW entries
+decoded=$(od -An -v -tu1 "$directory/telemetry" | awk '
+    function byte() {
+        if(position > count) { print "truncated"; exit 1 }
+        return bytes[position++]
+    }
+    function varint(    value, scale, b) {
+        value = 0; scale = 1
+        do { b = byte(); value += (b % 128) * scale; scale *= 128 } while(b >= 128)
+        return value
+    }
+    function signed(    value) {
+        value = varint()
+        return value % 2 ? -(value + 1) / 2 : value / 2
+    }
+    function string(    length_, text) {
+        length_ = varint(); text = ""
+        while(length_-- > 0) text = text sprintf("%c", byte())
+        return text
+    }
+    function fields(    flags) {
+        flags = byte()
+        if(flags % 2) { signed(); signed() }            # location
+        if(int(flags / 2) % 2) signed()                  # course
+        if(int(flags / 4) % 2) signed()                  # speed
+        if(int(flags / 8) % 2) signed()                  # fuel
+        if(int(flags / 16) % 2) byte()                   # ship state
+        if(int(flags / 32) % 2) signed()                 # resistance
+        if(int(flags / 64) % 2) signed()                 # cargo
+    }
+    { for(i = 1; i <= NF; i++) bytes[++count] = $i }
+    END {
+        position = 1
+        magic = ""
+        for(i = 0; i < 8; i++) magic = magic sprintf("%c", byte())
+        if(magic != "SHIPTELE" || byte() != 1) { print "bad header"; exit 1 }
+        varint()
+        time = 0
+        while(position <= count) {
+            if(byte() != 1) { print "expected a tick"; exit 1 }
+            time += signed(); id = 0
+            while((kind = byte()) != 0) {
+                id += signed()
+                if(kind == 2) {
+                    type = string(); names[id] = string()
+                    print time, "NEW", names[id], type; fields()
+                } else if(kind == 3) {
+                    print time, "CHANGED", names[id]; fields()
+                } else if(kind == 4) {
+                    print time, "GONE", names[id]
+                } else {
+                    print "bad entry kind " kind; exit 1
+                }
+            }
+        }
+    }') || { echo "FAIL: telemetry file does not decode"; printf '%s\n' "$decoded"; exit 1; }
+
+expected="2 NEW Ajax Cruiser
+4 GONE Ajax
+4 NEW Ajax Tanker"
+if [ "$(printf '%s\n' "$decoded" | grep ' Ajax')" != "$expected" ]; then
+    echo "FAIL: the replaced Ship is not recorded as gone and then new"
+    printf '%s\n' "$decoded"
+    exit 1
+fi
+echo "PASS: telemetry decodes, and a replaced Ship is recorded as gone and then new"